@@ -3,10 +3,18 @@
 
 #include "type_traits.h"
 #include "iterator.h"
+#include "simd.h"
 #include <type_traits>
 #include <cstring>
+#include <utility>
 
 namespace pocket_stl{
+    // 不指定比较函数时使用的 operator<，供 algorithm.h、heap.h 等共用
+    struct __less{
+        template <class T, class U>
+        bool operator()(const T& x, const U& y) const { return x < y; }
+    };
+
     /**************************** fill_n ****************************/
     template <class OutputIter, class Size, class T>
     OutputIter __fill_n(OutputIter first, Size n, const T& value){
@@ -32,6 +40,29 @@ namespace pocket_stl{
         return first + n;
     }
 
+    // 多字节的 trivially copyable 类型按位写入，元素较多时使用向量化的内核
+    // value 与元素类型不同时只接受算术类型之间的转换，保证与逐个赋值的结果相同
+    template <class Tp, class Size, class Up>
+    typename std::enable_if<
+                (sizeof(Tp) > 1) &&
+                    std::is_trivially_copyable<Tp>::value &&
+                    !std::is_volatile<Tp>::value &&
+                    (std::is_same<Tp, Up>::value ||
+                     (std::is_arithmetic<Tp>::value && std::is_arithmetic<Up>::value)),
+                Tp*
+            >::type
+    __fill_n(Tp* first, Size n, const Up& value){
+        if (!(n > 0)) return first;
+        const Tp tmp = value;
+        if (static_cast<size_t>(n) * sizeof(Tp) < 64){
+            for (Size i = 0; i < n; ++i) first[i] = tmp;
+        }
+        else{
+            __simd_fill(first, &tmp, sizeof(Tp), static_cast<size_t>(n));
+        }
+        return first + n;
+    }
+
     template <class OutputIter, class Size, class T>
     OutputIter fill_n(OutputIter first, Size n, const T& value){
         return __fill_n(first, n, value);
@@ -48,13 +79,38 @@ namespace pocket_stl{
     template <class RandomIter, class T>
     void __fill(RandomIter first, RandomIter last, const T& value,
                 pocket_stl::random_access_iterator_tag){
-        fill_n(first, last - first, value);
+        pocket_stl::fill_n(first, last - first, value);
     }
 
     template <class ForwardIter, class T>
-    void fill(ForwardIter first, ForwardIter last, const T& value){
+    void fill(ForwardIter first, ForwardIter last, const T& value);
+
+    template <class ForwardIter, class T>
+    void __segmented_fill(ForwardIter first, ForwardIter last, const T& value, std::false_type){
         __fill(first, last, value, iterator_category(first));
     }
+
+    // 分段迭代器（如 deque）逐段填充，每段是连续内存，可以走上面的 memset / 向量化内核
+    template <class ForwardIter, class T>
+    void __segmented_fill(ForwardIter first, ForwardIter last, const T& value, std::true_type){
+        typedef __segmented_iterator_traits<ForwardIter> traits;
+        typename traits::segment_iterator sf = traits::segment(first);
+        typename traits::segment_iterator sl = traits::segment(last);
+        if (sf == sl){
+            pocket_stl::fill(traits::local(first), traits::local(last), value);
+            return;
+        }
+        pocket_stl::fill(traits::local(first), traits::end(sf), value);
+        for (++sf; sf != sl; ++sf){
+            pocket_stl::fill(traits::begin(sf), traits::end(sf), value);
+        }
+        pocket_stl::fill(traits::begin(sl), traits::local(last), value);
+    }
+
+    template <class ForwardIter, class T>
+    void fill(ForwardIter first, ForwardIter last, const T& value){
+        __segmented_fill(first, last, value, typename __segmented_iterator_traits<ForwardIter>::is_segmented());
+    }
     /**************************** copy ****************************/
     template <class RandomAccessIterator, class OutputIterator, class Distance>
     inline OutputIterator __copy_d(RandomAccessIterator first, RandomAccessIterator last, 
@@ -116,11 +172,65 @@ namespace pocket_stl{
     };
 
 
+    // -------------------- 分段迭代器
+    // 源是分段迭代器时按源的段切分；目的是分段迭代器且源可随机访问时按目的的段切分，
+    // 切出的每一段都是连续内存之间的复制，可以落到上面的 memmove
     template <class InputIterator, class OutputIterator>
-    inline OutputIterator copy (InputIterator first, InputIterator last, OutputIterator result){
+    inline OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result);
+
+    template <class InputIterator, class OutputIterator, class Segmented, class Category>
+    inline OutputIterator __segmented_copy_out(InputIterator first, InputIterator last, OutputIterator result,
+                                               Segmented, Category){
         return __copy_dispatch<InputIterator, OutputIterator>()(first, last, result);
     }
 
+    template <class RandomAccessIterator, class OutputIterator>
+    OutputIterator __segmented_copy_out(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                        std::true_type, pocket_stl::random_access_iterator_tag){
+        typedef __segmented_iterator_traits<OutputIterator> traits;
+        typename iterator_traits<RandomAccessIterator>::difference_type n = last - first;
+        if (n <= 0) return result;
+        typename traits::segment_iterator seg = traits::segment(result);
+        typename traits::local_iterator local = traits::local(result);
+        for (;;){
+            const typename iterator_traits<RandomAccessIterator>::difference_type room = traits::end(seg) - local;
+            if (n <= room){
+                return traits::compose(seg, pocket_stl::copy(first, first + n, local));
+            }
+            pocket_stl::copy(first, first + room, local);
+            first += room;
+            n -= room;
+            local = traits::begin(++seg);
+        }
+    }
+
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator __segmented_copy(InputIterator first, InputIterator last, OutputIterator result, std::false_type){
+        return __segmented_copy_out(first, last, result,
+                                    typename __segmented_iterator_traits<OutputIterator>::is_segmented(),
+                                    pocket_stl::iterator_category(first));
+    }
+
+    template <class InputIterator, class OutputIterator>
+    OutputIterator __segmented_copy(InputIterator first, InputIterator last, OutputIterator result, std::true_type){
+        typedef __segmented_iterator_traits<InputIterator> traits;
+        typename traits::segment_iterator sf = traits::segment(first);
+        typename traits::segment_iterator sl = traits::segment(last);
+        if (sf == sl){
+            return pocket_stl::copy(traits::local(first), traits::local(last), result);
+        }
+        result = pocket_stl::copy(traits::local(first), traits::end(sf), result);
+        for (++sf; sf != sl; ++sf){
+            result = pocket_stl::copy(traits::begin(sf), traits::end(sf), result);
+        }
+        return pocket_stl::copy(traits::begin(sl), traits::local(last), result);
+    }
+
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator copy (InputIterator first, InputIterator last, OutputIterator result){
+        return __segmented_copy(first, last, result, typename __segmented_iterator_traits<InputIterator>::is_segmented());
+    }
+
     inline char* copy(const char* first, const char* last, char* result){
         memmove(result, first, last - first);
         return result + (last - first);
@@ -196,6 +306,84 @@ namespace pocket_stl{
         return __copy_backward_dispatch<BidirectionalIterator1, BidirectionalIterator2>()(first, last, result);
     }
 
+    /**************************** move ****************************/
+    // 与 copy 相同，但对每个元素做移动赋值；平凡赋值的类型直接 memmove
+    template <class T>
+    inline T* __move_t(T* first, T* last, T* result, pocket_stl::__true_type){
+        return __copy_t(first, last, result, pocket_stl::__true_type());
+    }
+
+    template <class T>
+    inline T* __move_t(T* first, T* last, T* result, pocket_stl::__false_type){
+        for (; first != last; ++first, ++result){
+            *result = std::move(*first);
+        }
+        return result;
+    }
+
+    template <class InputIterator, class OutputIterator>
+    struct __move_dispatch{
+        OutputIterator operator()(InputIterator first, InputIterator last, OutputIterator result){
+            for (; first != last; ++first, ++result){
+                *result = std::move(*first);
+            }
+            return result;
+        }
+    };
+
+    template <class T>
+    struct __move_dispatch<T*, T*>{
+        T* operator()(T* first, T* last, T* result){
+            typedef typename pocket_stl::__bool_type<std::is_trivially_move_assignable<T>::value>::type t;
+            return __move_t(first, last, result, t());
+        }
+    };
+
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator move(InputIterator first, InputIterator last, OutputIterator result){
+        return __move_dispatch<InputIterator, OutputIterator>()(first, last, result);
+    }
+
+    /**************************** move_backward ****************************/
+    template <class T>
+    inline T* __move_backward_t(T* first, T* last, T* result, pocket_stl::__true_type){
+        return __copy_backward_t(first, last, result, pocket_stl::__true_type());
+    }
+
+    template <class T>
+    inline T* __move_backward_t(T* first, T* last, T* result, pocket_stl::__false_type){
+        while (first != last){
+            *--result = std::move(*--last);
+        }
+        return result;
+    }
+
+    template <class BidirectionalIterator1, class BidirectionalIterator2>
+    struct __move_backward_dispatch{
+        BidirectionalIterator2 operator()(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                          BidirectionalIterator2 result){
+            while (first != last){
+                *--result = std::move(*--last);
+            }
+            return result;
+        }
+    };
+
+    template <class T>
+    struct __move_backward_dispatch<T*, T*>{
+        T* operator()(T* first, T* last, T* result){
+            typedef typename pocket_stl::__bool_type<std::is_trivially_move_assignable<T>::value>::type t;
+            return __move_backward_t(first, last, result, t());
+        }
+    };
+
+    template <class BidirectionalIterator1, class BidirectionalIterator2>
+    BidirectionalIterator2 move_backward(BidirectionalIterator1 first,
+                                         BidirectionalIterator1 last,
+                                         BidirectionalIterator2 result){
+        return __move_backward_dispatch<BidirectionalIterator1, BidirectionalIterator2>()(first, last, result);
+    }
+
     /**************************** copy_n ****************************/
     template <class InputIterator, class Size, class OutputIterator>
     OutputIterator
@@ -222,6 +410,198 @@ namespace pocket_stl{
     OutputIterator copy_n (InputIterator first, Size n, OutputIterator result){
         return __copy_n(first, n, result);
     }
+
+    /**************************** 按位比较 ****************************/
+    // 两个值相等当且仅当对象表示相同：整数、枚举与指针满足，浮点数（+0.0 / -0.0、NaN）和可能带填充的类类型不满足
+    template <class T, class U>
+    struct __is_bitwise_comparable : public std::integral_constant<bool,
+            std::is_same<typename std::remove_cv<T>::type, typename std::remove_cv<U>::type>::value &&
+            (std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value)> {};
+
+    // 进一步地，memcmp 的结果与 operator< 的顺序一致：单字节的无符号类型
+    template <class T, class U>
+    struct __is_memcmp_ordered : public std::integral_constant<bool,
+            __is_bitwise_comparable<T, U>::value && sizeof(T) == 1 &&
+            (std::is_same<typename std::remove_cv<T>::type, bool>::value ||
+             (std::is_integral<T>::value && std::is_unsigned<T>::value))> {};
+
+    /**************************** mismatch ****************************/
+    template <class InputIterator1, class InputIterator2>
+    std::pair<InputIterator1, InputIterator2>
+    __mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
+        while (first1 != last1 && *first1 == *first2){
+            ++first1;
+            ++first2;
+        }
+        return std::pair<InputIterator1, InputIterator2>(first1, first2);
+    }
+
+    template <class Tp, class Up>
+    typename std::enable_if<__is_bitwise_comparable<Tp, Up>::value, std::pair<Tp*, Up*>>::type
+    __mismatch(Tp* first1, Tp* last1, Up* first2){
+        const size_t i = __simd_mismatch(first1, first2, sizeof(Tp) * (last1 - first1)) / sizeof(Tp);
+        return std::pair<Tp*, Up*>(first1 + i, first2 + i);
+    }
+
+    template <class InputIterator1, class InputIterator2>
+    std::pair<InputIterator1, InputIterator2>
+    mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
+        return __mismatch(first1, last1, first2);
+    }
+
+    template <class InputIterator1, class InputIterator2, class BinaryPredicate>
+    std::pair<InputIterator1, InputIterator2>
+    mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred){
+        while (first1 != last1 && pred(*first1, *first2)){
+            ++first1;
+            ++first2;
+        }
+        return std::pair<InputIterator1, InputIterator2>(first1, first2);
+    }
+
+    /**************************** equal ****************************/
+    template <class InputIterator1, class InputIterator2>
+    bool __equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
+        for (; first1 != last1; ++first1, ++first2){
+            if (!(*first1 == *first2)) return false;
+        }
+        return true;
+    }
+
+    template <class Tp, class Up>
+    typename std::enable_if<__is_bitwise_comparable<Tp, Up>::value, bool>::type
+    __equal(Tp* first1, Tp* last1, Up* first2){
+        return first1 == last1 || std::memcmp(first1, first2, sizeof(Tp) * (last1 - first1)) == 0;
+    }
+
+    template <class InputIterator1, class InputIterator2>
+    bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
+        return __equal(first1, last1, first2);
+    }
+
+    template <class InputIterator1, class InputIterator2, class BinaryPredicate>
+    bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred){
+        for (; first1 != last1; ++first1, ++first2){
+            if (!pred(*first1, *first2)) return false;
+        }
+        return true;
+    }
+
+    /**************************** lexicographical_compare ****************************/
+    // 三路比较：[first1, last1) 小于、等于、大于 [first2, last2) 时分别返回负数、0、正数，deque 逐块比较时使用
+    template <class InputIterator1, class InputIterator2>
+    int __lexicographical_compare_3way(InputIterator1 first1, InputIterator1 last1,
+                                       InputIterator2 first2, InputIterator2 last2){
+        for (; first1 != last1 && first2 != last2; ++first1, ++first2){
+            if (*first1 < *first2) return -1;
+            if (*first2 < *first1) return 1;
+        }
+        return first2 != last2 ? -1 : (first1 != last1 ? 1 : 0);
+    }
+
+    template <class Tp, class Up>
+    typename std::enable_if<__is_bitwise_comparable<Tp, Up>::value, int>::type
+    __lexicographical_compare_3way(Tp* first1, Tp* last1, Up* first2, Up* last2){
+        const ptrdiff_t len1 = last1 - first1;
+        const ptrdiff_t len2 = last2 - first2;
+        const ptrdiff_t len = len1 < len2 ? len1 : len2;
+        if (__is_memcmp_ordered<Tp, Up>::value){
+            const int r = len == 0 ? 0 : std::memcmp(first1, first2, static_cast<size_t>(len));
+            if (r != 0) return r;
+        }
+        else{
+            // 先按字节找到第一个不同的元素，再由它决定大小
+            const ptrdiff_t i = static_cast<ptrdiff_t>(__simd_mismatch(first1, first2, sizeof(Tp) * len) / sizeof(Tp));
+            if (i != len) return first1[i] < first2[i] ? -1 : 1;
+        }
+        return len1 < len2 ? -1 : (len2 < len1 ? 1 : 0);
+    }
+
+    template <class InputIterator1, class InputIterator2>
+    bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
+                                 InputIterator2 first2, InputIterator2 last2){
+        return __lexicographical_compare_3way(first1, last1, first2, last2) < 0;
+    }
+
+    template <class InputIterator1, class InputIterator2, class Compare>
+    bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
+                                 InputIterator2 first2, InputIterator2 last2, Compare comp){
+        for (; first1 != last1 && first2 != last2; ++first1, ++first2){
+            if (comp(*first1, *first2)) return true;
+            if (comp(*first2, *first1)) return false;
+        }
+        return first1 == last1 && first2 != last2;
+    }
+
+    /**************************** find ****************************/
+    template <class InputIterator, class T>
+    InputIterator __find(InputIterator first, InputIterator last, const T& value){
+        for (; first != last && !(*first == value); ++first) {}
+        return first;
+    }
+
+    // 可按位比较的元素在连续内存上用 memchr / 向量化内核查找
+    // value 与元素类型不同时只接受整数之间的比较：先换算成元素类型，换算后与 value 不相等说明没有元素能与之相等
+    template <class Tp, class Up>
+    struct __is_find_bitwise : public std::integral_constant<bool,
+            !std::is_volatile<Tp>::value &&
+            (sizeof(Tp) == 1 || sizeof(Tp) == 2 || sizeof(Tp) == 4 || sizeof(Tp) == 8) &&
+            (__is_bitwise_comparable<Tp, Up>::value ||
+             (std::is_integral<Tp>::value && std::is_integral<Up>::value &&
+              !std::is_same<typename std::remove_cv<Tp>::type, bool>::value &&
+              !std::is_same<typename std::remove_cv<Up>::type, bool>::value))> {};
+
+    template <class Tp, class Up>
+    typename std::enable_if<__is_find_bitwise<Tp, Up>::value, Tp*>::type
+    __find(Tp* first, Tp* last, const Up& value){
+        typedef typename std::remove_cv<Tp>::type T;
+        typedef typename std::common_type<T, Up>::type C;
+        const T tmp = static_cast<T>(value);
+        if (!(static_cast<C>(tmp) == static_cast<C>(value)) || first == last) return last;
+        return first + __simd_find(first, sizeof(T), static_cast<size_t>(last - first), &tmp);
+    }
+
+    template <class InputIterator, class T>
+    InputIterator find(InputIterator first, InputIterator last, const T& value);
+
+    template <class InputIterator, class T>
+    InputIterator __segmented_find(InputIterator first, InputIterator last, const T& value, std::false_type){
+        return __find(first, last, value);
+    }
+
+    // 分段迭代器逐段查找，找到时再拼回分段迭代器
+    template <class InputIterator, class T>
+    InputIterator __segmented_find(InputIterator first, InputIterator last, const T& value, std::true_type){
+        typedef __segmented_iterator_traits<InputIterator> traits;
+        typename traits::segment_iterator sf = traits::segment(first);
+        typename traits::segment_iterator sl = traits::segment(last);
+        if (sf == sl){
+            typename traits::local_iterator p = pocket_stl::find(traits::local(first), traits::local(last), value);
+            return p == traits::local(last) ? last : traits::compose(sf, p);
+        }
+        typename traits::local_iterator e = traits::end(sf);
+        typename traits::local_iterator p = pocket_stl::find(traits::local(first), e, value);
+        if (p != e) return traits::compose(sf, p);
+        for (++sf; sf != sl; ++sf){
+            e = traits::end(sf);
+            p = pocket_stl::find(traits::begin(sf), e, value);
+            if (p != e) return traits::compose(sf, p);
+        }
+        p = pocket_stl::find(traits::begin(sl), traits::local(last), value);
+        return p == traits::local(last) ? last : traits::compose(sl, p);
+    }
+
+    template <class InputIterator, class T>
+    InputIterator find(InputIterator first, InputIterator last, const T& value){
+        return __segmented_find(first, last, value, typename __segmented_iterator_traits<InputIterator>::is_segmented());
+    }
+
+    /**************************** find_if ****************************/
+    template <class InputIterator, class Predicate>
+    InputIterator find_if(InputIterator first, InputIterator last, Predicate pred){
+        for (; first != last && !pred(*first); ++first) {}
+        return first;
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,1383 @@
+#ifndef _POCKET_ALGORITHM_H_
+#define _POCKET_ALGORITHM_H_
+
+/*
+** algorithm
+** sort 使用 pattern-defeating quicksort（pdqsort）：小区间插入排序，ninther 取枢轴，
+** 已经有序或含大量重复元素的输入接近线性时间；划分严重失衡的次数超过 log2(n) 时改用堆排序，最坏 O(nlogn)
+** 默认比较的算术类型在连续空间上使用 BlockQuicksort 式的无分支划分，避免分支预测失败
+** radix_sort 对整数与浮点数键做 LSD 基数排序，每趟处理 8 或 11 位，需要与区间等长的临时缓冲区
+** stable_sort 与 inplace_merge 通过 temporary_buffer 申请缓冲区：stable_sort 只需要一半长度，inplace_merge 只需要较短一段的长度；
+** 申请到的缓冲区不够时切分后递归，完全申请不到时退回只靠 rotate 的原地归并
+** lower_bound / upper_bound 在随机访问迭代器上使用无分支的二分查找，连续空间上预取下一轮的中点
+** set_intersection / set_union / set_difference / includes 在两段长度悬殊时对较长一段做倍增查找（galloping）
+*/
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "iterator.h"
+#include "algobase.h"
+#include "heap.h"
+#include "functional.h"
+#include "construct.h"
+#include "memory.h"
+
+namespace pocket_stl{
+
+    enum {
+        __INSERTION_SORT_THRESHOLD      = 24,   // 小于该长度的区间做插入排序
+        __NINTHER_THRESHOLD             = 128,  // 大于该长度的区间用 ninther 取枢轴
+        __PARTIAL_INSERTION_SORT_LIMIT  = 8,    // 划分后尝试插入排序时允许移动的元素个数
+        __BLOCK_SIZE                    = 64,   // 无分支划分每次处理的元素个数，偏移量存为 unsigned char
+        __CACHELINE_SIZE                = 64
+    };
+
+    // 比较的结果不依赖于分支的代价，算术类型配合这些比较函数才使用无分支划分
+    template <class Compare>
+    struct __is_default_compare : public std::false_type {};
+    template <>
+    struct __is_default_compare<__less> : public std::true_type {};
+    template <class T>
+    struct __is_default_compare<std::less<T>> : public std::true_type {};
+    template <class T>
+    struct __is_default_compare<std::greater<T>> : public std::true_type {};
+    template <class T>
+    struct __is_default_compare<less<T>> : public std::true_type {};
+    template <class T>
+    struct __is_default_compare<greater<T>> : public std::true_type {};
+
+    // 偏移量加迭代器对 deque 迭代器代价较高，无分支划分只用于连续空间
+    template <class RandomIter, class Compare>
+    struct __use_branchless_partition : public std::integral_constant<bool,
+        __is_default_compare<Compare>::value &&
+        std::is_arithmetic<typename iterator_traits<RandomIter>::value_type>::value &&
+        std::is_pointer<RandomIter>::value> {};
+
+    template <class Iter1, class Iter2>
+    inline void __iter_swap(Iter1 a, Iter2 b){
+        using std::swap;
+        swap(*a, *b);
+    }
+
+    /**************************** for_each ****************************/
+    template <class InputIterator, class Function>
+    Function for_each(InputIterator first, InputIterator last, Function f){
+        for (; first != last; ++first){
+            f(*first);
+        }
+        return f;
+    }
+
+    /**************************** transform ****************************/
+    template <class InputIterator, class OutputIterator, class UnaryOperation>
+    OutputIterator transform(InputIterator first, InputIterator last, OutputIterator result, UnaryOperation op){
+        for (; first != last; ++first, ++result){
+            *result = op(*first);
+        }
+        return result;
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class BinaryOperation>
+    OutputIterator transform(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+                             OutputIterator result, BinaryOperation op){
+        for (; first1 != last1; ++first1, ++first2, ++result){
+            *result = op(*first1, *first2);
+        }
+        return result;
+    }
+
+    /**************************** insertion sort ****************************/
+    template <class RandomIter, class Compare>
+    void __insertion_sort(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if (first == last) return;
+        for (RandomIter cur = first + 1; cur != last; ++cur){
+            RandomIter sift = cur;
+            RandomIter sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)){
+                T tmp = std::move(*sift);
+                do { *sift-- = std::move(*sift_1); }
+                while (sift != first && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    // 要求 first 之前存在不大于区间内任何元素的元素，内层循环不检查边界
+    template <class RandomIter, class Compare>
+    void __unguarded_insertion_sort(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if (first == last) return;
+        for (RandomIter cur = first + 1; cur != last; ++cur){
+            RandomIter sift = cur;
+            RandomIter sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)){
+                T tmp = std::move(*sift);
+                do { *sift-- = std::move(*sift_1); }
+                while (comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    // 移动的元素超过 __PARTIAL_INSERTION_SORT_LIMIT 个就放弃并返回 false，区间仍是原区间的一个排列
+    template <class RandomIter, class Compare>
+    bool __partial_insertion_sort(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if (first == last) return true;
+        size_t limit = 0;
+        for (RandomIter cur = first + 1; cur != last; ++cur){
+            RandomIter sift = cur;
+            RandomIter sift_1 = cur - 1;
+            if (comp(*sift, *sift_1)){
+                T tmp = std::move(*sift);
+                do { *sift-- = std::move(*sift_1); }
+                while (sift != first && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+                limit += cur - sift;
+            }
+            if (limit > __PARTIAL_INSERTION_SORT_LIMIT) return false;
+        }
+        return true;
+    }
+
+    /**************************** partition ****************************/
+    template <class RandomIter, class Compare>
+    inline void __sort2(RandomIter a, RandomIter b, Compare comp){
+        if (comp(*b, *a)) pocket_stl::__iter_swap(a, b);
+    }
+
+    template <class RandomIter, class Compare>
+    inline void __sort3(RandomIter a, RandomIter b, RandomIter c, Compare comp){
+        pocket_stl::__sort2(a, b, comp);
+        pocket_stl::__sort2(b, c, comp);
+        pocket_stl::__sort2(a, b, comp);
+    }
+
+    // 以 *first 为枢轴，把小于枢轴的元素放到左边，返回枢轴的最终位置，以及划分前区间是否已经有序地分好
+    template <class RandomIter, class Compare>
+    std::pair<RandomIter, bool> __partition_right(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        T pivot(std::move(*first));
+        RandomIter begin = first;
+        RandomIter l = first;
+        RandomIter r = last;
+
+        // 枢轴是三个元素的中位数，左侧一定存在不小于它的元素；右侧只有 l 没有前进时才需要检查边界
+        while (comp(*++l, pivot));
+        if (l - 1 == begin) while (l < r && !comp(*--r, pivot));
+        else                while (!comp(*--r, pivot));
+
+        const bool already_partitioned = !(l < r);
+        while (l < r){
+            pocket_stl::__iter_swap(l, r);
+            while (comp(*++l, pivot));
+            while (!comp(*--r, pivot));
+        }
+
+        RandomIter pivot_pos = l - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return std::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+    }
+
+    // 把 offsets 记录的左右两侧放错位置的元素成对交换；个数相同时用循环移位代替交换，少一半的移动
+    template <class RandomIter>
+    inline void __swap_offsets(RandomIter first, RandomIter last,
+                               unsigned char* offsets_l, unsigned char* offsets_r,
+                               size_t num, bool use_swaps){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if (use_swaps){
+            for (size_t i = 0; i < num; ++i){
+                pocket_stl::__iter_swap(first + offsets_l[i], last - offsets_r[i]);
+            }
+        }
+        else if (num > 0){
+            RandomIter l = first + offsets_l[0];
+            RandomIter r = last - offsets_r[0];
+            T tmp(std::move(*l));
+            *l = std::move(*r);
+            for (size_t i = 1; i < num; ++i){
+                l = first + offsets_l[i];
+                *r = std::move(*l);
+                r = last - offsets_r[i];
+                *l = std::move(*r);
+            }
+            *r = std::move(tmp);
+        }
+    }
+
+    // 与 __partition_right 结果相同，但先整块地把比较结果写成偏移量，再统一交换，比较不产生分支
+    template <class RandomIter, class Compare>
+    std::pair<RandomIter, bool> __partition_right_branchless(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        T pivot(std::move(*first));
+        RandomIter begin = first;
+        RandomIter l = first;
+        RandomIter r = last;
+
+        while (comp(*++l, pivot));
+        if (l - 1 == begin) while (l < r && !comp(*--r, pivot));
+        else                while (!comp(*--r, pivot));
+
+        const bool already_partitioned = !(l < r);
+        if (!already_partitioned){
+            pocket_stl::__iter_swap(l, r);
+            ++l;
+
+            alignas(__CACHELINE_SIZE) unsigned char offsets_l[__BLOCK_SIZE];
+            alignas(__CACHELINE_SIZE) unsigned char offsets_r[__BLOCK_SIZE];
+            RandomIter offsets_l_base = l;
+            RandomIter offsets_r_base = r;
+            size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+            while (l < r){
+                // 两侧都没有待交换的元素时平分剩余区间，否则只补充用完的一侧
+                const size_t num_unknown = r - l;
+                const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+                if (left_split >= __BLOCK_SIZE){
+                    for (size_t i = 0; i < __BLOCK_SIZE;){
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*l, pivot); ++l;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*l, pivot); ++l;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*l, pivot); ++l;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*l, pivot); ++l;
+                    }
+                }
+                else{
+                    for (size_t i = 0; i < left_split;){
+                        offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*l, pivot); ++l;
+                    }
+                }
+
+                if (right_split >= __BLOCK_SIZE){
+                    for (size_t i = 0; i < __BLOCK_SIZE;){
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--r, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--r, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--r, pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--r, pivot);
+                    }
+                }
+                else{
+                    for (size_t i = 0; i < right_split;){
+                        offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--r, pivot);
+                    }
+                }
+
+                const size_t num = num_l < num_r ? num_l : num_r;
+                pocket_stl::__swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r,
+                               num, num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if (num_l == 0){
+                    start_l = 0;
+                    offsets_l_base = l;
+                }
+                if (num_r == 0){
+                    start_r = 0;
+                    offsets_r_base = r;
+                }
+            }
+
+            // 剩下的只有一侧，把它们逐个换到中间
+            if (num_l){
+                while (num_l--) pocket_stl::__iter_swap(offsets_l_base + offsets_l[start_l + num_l], --r);
+                l = r;
+            }
+            if (num_r){
+                while (num_r--) pocket_stl::__iter_swap(offsets_r_base - offsets_r[start_r + num_r], l), ++l;
+                r = l;
+            }
+        }
+
+        RandomIter pivot_pos = l - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return std::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+    }
+
+    // 把等于枢轴的元素放到左边，返回枢轴位置；用于左侧已有等于枢轴的元素时一次跳过所有重复元素
+    template <class RandomIter, class Compare>
+    RandomIter __partition_left(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        T pivot(std::move(*first));
+        RandomIter l = first;
+        RandomIter r = last;
+
+        while (comp(pivot, *--r));
+        if (r + 1 == last) while (l < r && !comp(pivot, *++l));
+        else               while (!comp(pivot, *++l));
+
+        while (l < r){
+            pocket_stl::__iter_swap(l, r);
+            while (comp(pivot, *--r));
+            while (!comp(pivot, *++l));
+        }
+
+        RandomIter pivot_pos = r;
+        *first = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return pivot_pos;
+    }
+
+    /**************************** sort ****************************/
+    // 打乱失衡划分两侧的若干元素，破坏构造出来的坏输入
+    template <class RandomIter, class Distance>
+    void __break_patterns(RandomIter first, RandomIter pivot_pos, RandomIter last, Distance l_size, Distance r_size){
+        if (l_size >= __INSERTION_SORT_THRESHOLD){
+            pocket_stl::__iter_swap(first, first + l_size / 4);
+            pocket_stl::__iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+            if (l_size > __NINTHER_THRESHOLD){
+                pocket_stl::__iter_swap(first + 1, first + (l_size / 4 + 1));
+                pocket_stl::__iter_swap(first + 2, first + (l_size / 4 + 2));
+                pocket_stl::__iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                pocket_stl::__iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+            }
+        }
+        if (r_size >= __INSERTION_SORT_THRESHOLD){
+            pocket_stl::__iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+            pocket_stl::__iter_swap(last - 1, last - r_size / 4);
+            if (r_size > __NINTHER_THRESHOLD){
+                pocket_stl::__iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                pocket_stl::__iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                pocket_stl::__iter_swap(last - 2, last - (1 + r_size / 4));
+                pocket_stl::__iter_swap(last - 3, last - (2 + r_size / 4));
+            }
+        }
+    }
+
+    // 三数取中或 ninther 选出枢轴放到 first，区间长度不小于 __INSERTION_SORT_THRESHOLD
+    template <class RandomIter, class Compare>
+    inline void __choose_pivot(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        const Distance size = last - first;
+        const Distance s2 = size / 2;
+        if (size > __NINTHER_THRESHOLD){
+            pocket_stl::__sort3(first, first + s2, last - 1, comp);
+            pocket_stl::__sort3(first + 1, first + (s2 - 1), last - 2, comp);
+            pocket_stl::__sort3(first + 2, first + (s2 + 1), last - 3, comp);
+            pocket_stl::__sort3(first + (s2 - 1), first + s2, first + (s2 + 1), comp);
+            pocket_stl::__iter_swap(first, first + s2);
+        }
+        else{
+            pocket_stl::__sort3(first + s2, first, last - 1, comp);
+        }
+    }
+
+    // leftmost 为 false 时 *(first - 1) 不大于区间内的任何元素
+    template <bool Branchless, class RandomIter, class Compare>
+    void __pdqsort_loop(RandomIter first, RandomIter last, Compare comp, int bad_allowed, bool leftmost){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        while (true){
+            const Distance size = last - first;
+            if (size < __INSERTION_SORT_THRESHOLD){
+                if (leftmost) pocket_stl::__insertion_sort(first, last, comp);
+                else          pocket_stl::__unguarded_insertion_sort(first, last, comp);
+                return;
+            }
+
+            pocket_stl::__choose_pivot(first, last, comp);
+
+            // 枢轴等于左侧相邻的元素，说明区间中所有等于它的元素都可以一次排好
+            if (!leftmost && !comp(*(first - 1), *first)){
+                first = pocket_stl::__partition_left(first, last, comp) + 1;
+                continue;
+            }
+
+            std::pair<RandomIter, bool> part = Branchless ? pocket_stl::__partition_right_branchless(first, last, comp)
+                                                          : pocket_stl::__partition_right(first, last, comp);
+            RandomIter pivot_pos = part.first;
+            const Distance l_size = pivot_pos - first;
+            const Distance r_size = last - (pivot_pos + 1);
+
+            if (l_size < size / 8 || r_size < size / 8){
+                if (--bad_allowed == 0){
+                    pocket_stl::__make_heap<2>(first, last, comp);
+                    pocket_stl::__sort_heap<2>(first, last, comp);
+                    return;
+                }
+                pocket_stl::__break_patterns(first, pivot_pos, last, l_size, r_size);
+            }
+            else if (part.second && pocket_stl::__partial_insertion_sort(first, pivot_pos, comp)
+                                 && pocket_stl::__partial_insertion_sort(pivot_pos + 1, last, comp)){
+                // 划分时没有交换过元素，两侧很可能已经有序
+                return;
+            }
+
+            // 递归处理左侧，循环处理右侧
+            pocket_stl::__pdqsort_loop<Branchless>(first, pivot_pos, comp, bad_allowed, leftmost);
+            first = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+
+    template <class Size>
+    inline int __log2(Size n){
+        int log = 0;
+        while (n >>= 1) ++log;
+        return log;
+    }
+
+    template <class RandomIter, class Compare>
+    void __sort(RandomIter first, RandomIter last, Compare comp, random_access_iterator_tag){
+        if (last - first < 2) return;
+        pocket_stl::__pdqsort_loop<__use_branchless_partition<RandomIter, Compare>::value>(first, last, comp, pocket_stl::__log2(last - first), true);
+    }
+
+    template <class RandomIter, class Compare>
+    void sort(RandomIter first, RandomIter last, Compare comp){
+        pocket_stl::__sort(first, last, comp, iterator_category(first));
+    }
+
+    template <class RandomIter>
+    void sort(RandomIter first, RandomIter last){
+        pocket_stl::__sort(first, last, __less(), iterator_category(first));
+    }
+
+    /**************************** lower_bound / upper_bound / equal_range ****************************/
+    // 第一个不小于 value 的位置
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter __lower_bound(ForwardIter first, ForwardIter last, const T& value, Compare comp, forward_iterator_tag){
+        typedef typename iterator_traits<ForwardIter>::difference_type Distance;
+        Distance len = pocket_stl::distance(first, last);
+        while (len > 0){
+            const Distance half = len / 2;
+            ForwardIter mid = first;
+            pocket_stl::advance(mid, half);
+            if (comp(*mid, value)){
+                first = ++mid;
+                len -= half + 1;
+            }
+            else{
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    // 连续空间上预取下一轮两个可能的中点，区间大于缓存时把相邻两轮的缓存缺失重叠起来
+    template <class RandomIter, class Distance>
+    inline void __prefetch_midpoints(RandomIter, Distance, Distance, Distance) noexcept {}
+
+    template <class T, class Distance>
+    inline void __prefetch_midpoints(T* first, Distance base, Distance half, Distance next_len) noexcept{
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(first + (base + next_len / 2));
+        __builtin_prefetch(first + (base + half + next_len / 2));
+#else
+        (void)first; (void)base; (void)half; (void)next_len;
+#endif
+    }
+
+    // 随机访问迭代器上每轮只根据比较结果决定起点是否前移 half，长度固定减半，
+    // 比较结果编译为条件传送而不是分支，查找随机的键时没有分支预测失败
+    template <class RandomIter, class T, class Compare>
+    RandomIter __lower_bound(RandomIter first, RandomIter last, const T& value, Compare comp, random_access_iterator_tag){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        Distance len = last - first;
+        if (len == 0) return first;
+        Distance base = 0;
+        while (len > 1){
+            const Distance half = len / 2;
+            pocket_stl::__prefetch_midpoints(first, base, half, len - half);
+            base = comp(*(first + (base + half)), value) ? base + half : base;
+            len -= half;
+        }
+        return first + (base + Distance(comp(*(first + base), value)));
+    }
+
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T& value, Compare comp){
+        return pocket_stl::__lower_bound(first, last, value, comp, iterator_category(first));
+    }
+
+    template <class ForwardIter, class T>
+    ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T& value){
+        return pocket_stl::lower_bound(first, last, value, __less());
+    }
+
+    // 第一个大于 value 的位置
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter __upper_bound(ForwardIter first, ForwardIter last, const T& value, Compare comp, forward_iterator_tag){
+        typedef typename iterator_traits<ForwardIter>::difference_type Distance;
+        Distance len = pocket_stl::distance(first, last);
+        while (len > 0){
+            const Distance half = len / 2;
+            ForwardIter mid = first;
+            pocket_stl::advance(mid, half);
+            if (comp(value, *mid)){
+                len = half;
+            }
+            else{
+                first = ++mid;
+                len -= half + 1;
+            }
+        }
+        return first;
+    }
+
+    template <class RandomIter, class T, class Compare>
+    RandomIter __upper_bound(RandomIter first, RandomIter last, const T& value, Compare comp, random_access_iterator_tag){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        Distance len = last - first;
+        if (len == 0) return first;
+        Distance base = 0;
+        while (len > 1){
+            const Distance half = len / 2;
+            pocket_stl::__prefetch_midpoints(first, base, half, len - half);
+            base = !comp(value, *(first + (base + half))) ? base + half : base;
+            len -= half;
+        }
+        return first + (base + Distance(!comp(value, *(first + base))));
+    }
+
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T& value, Compare comp){
+        return pocket_stl::__upper_bound(first, last, value, comp, iterator_category(first));
+    }
+
+    template <class ForwardIter, class T>
+    ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T& value){
+        return pocket_stl::upper_bound(first, last, value, __less());
+    }
+
+    // 等于 value 的元素所在的区间；upper_bound 从 lower_bound 的结果开始找
+    template <class ForwardIter, class T, class Compare>
+    std::pair<ForwardIter, ForwardIter> equal_range(ForwardIter first, ForwardIter last, const T& value, Compare comp){
+        ForwardIter lower = pocket_stl::lower_bound(first, last, value, comp);
+        return std::pair<ForwardIter, ForwardIter>(lower, pocket_stl::upper_bound(lower, last, value, comp));
+    }
+
+    template <class ForwardIter, class T>
+    std::pair<ForwardIter, ForwardIter> equal_range(ForwardIter first, ForwardIter last, const T& value){
+        return pocket_stl::equal_range(first, last, value, __less());
+    }
+
+    /**************************** rotate ****************************/
+    // 交换 [first, middle) 与 [middle, last)，返回原来的 *first 的新位置
+    template <class ForwardIter>
+    ForwardIter rotate(ForwardIter first, ForwardIter middle, ForwardIter last){
+        if (first == middle) return last;
+        if (middle == last) return first;
+        ForwardIter next = middle;
+        do{
+            pocket_stl::__iter_swap(first++, next++);
+            if (first == middle) middle = next;
+        } while (next != last);
+        ForwardIter ret = first;
+        next = middle;
+        while (next != last){
+            pocket_stl::__iter_swap(first++, next++);
+            if (first == middle) middle = next;
+            else if (next == last) next = middle;
+        }
+        return ret;
+    }
+
+    /**************************** merge ****************************/
+    // 相等的元素先取第一个区间的，归并是稳定的
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                     OutputIter result, Compare comp){
+        for (; first1 != last1 && first2 != last2; ++result){
+            if (comp(*first2, *first1)){
+                *result = *first2;
+                ++first2;
+            }
+            else{
+                *result = *first1;
+                ++first1;
+            }
+        }
+        return pocket_stl::copy(first2, last2, pocket_stl::copy(first1, last1, result));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result){
+        return pocket_stl::merge(first1, last1, first2, last2, result, __less());
+    }
+
+    // 与 merge 相同，但移动元素
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __move_merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                            OutputIter result, Compare comp){
+        for (; first1 != last1 && first2 != last2; ++result){
+            if (comp(*first2, *first1)){
+                *result = std::move(*first2);
+                ++first2;
+            }
+            else{
+                *result = std::move(*first1);
+                ++first1;
+            }
+        }
+        return pocket_stl::move(first2, last2, pocket_stl::move(first1, last1, result));
+    }
+
+    /**************************** inplace_merge ****************************/
+    // 前一段已移到缓冲区 [first1, last1)，后一段 [first2, last2) 留在原处，从 result 开始向后写
+    // 缓冲区先用完时后一段剩下的元素已经在最终位置上
+    template <class Pointer, class BidirIter, class Compare>
+    void __move_merge_forward(Pointer first1, Pointer last1, BidirIter first2, BidirIter last2,
+                              BidirIter result, Compare comp){
+        for (; first1 != last1 && first2 != last2; ++result){
+            if (comp(*first2, *first1)){
+                *result = std::move(*first2);
+                ++first2;
+            }
+            else{
+                *result = std::move(*first1);
+                ++first1;
+            }
+        }
+        pocket_stl::move(first1, last1, result);
+    }
+
+    // 后一段已移到缓冲区 [first2, last2)，前一段 [first1, last1) 留在原处，从 result 开始向前写
+    template <class BidirIter, class Pointer, class Compare>
+    void __move_merge_backward(BidirIter first1, BidirIter last1, Pointer first2, Pointer last2,
+                               BidirIter result, Compare comp){
+        if (first2 == last2) return;
+        if (first1 == last1){
+            pocket_stl::move_backward(first2, last2, result);
+            return;
+        }
+        --last1;
+        --last2;
+        for (;;){
+            if (comp(*last2, *last1)){
+                *--result = std::move(*last1);
+                if (first1 == last1){
+                    pocket_stl::move_backward(first2, ++last2, result);
+                    return;
+                }
+                --last1;
+            }
+            else{
+                *--result = std::move(*last2);
+                if (first2 == last2) return;
+                --last2;
+            }
+        }
+    }
+
+    // 较短的一段放得进缓冲区时借助缓冲区交换两段，否则退回 rotate
+    template <class BidirIter, class Distance, class Pointer>
+    BidirIter __rotate_adaptive(BidirIter first, BidirIter middle, BidirIter last,
+                                Distance len1, Distance len2, Pointer buffer, Distance buffer_size){
+        if (len1 > len2 && len2 <= buffer_size){
+            if (len2 == 0) return first;
+            Pointer buffer_end = pocket_stl::move(middle, last, buffer);
+            pocket_stl::move_backward(first, middle, last);
+            return pocket_stl::move(buffer, buffer_end, first);
+        }
+        if (len1 <= buffer_size){
+            if (len1 == 0) return last;
+            Pointer buffer_end = pocket_stl::move(first, middle, buffer);
+            pocket_stl::move(middle, last, first);
+            return pocket_stl::move_backward(buffer, buffer_end, last);
+        }
+        return pocket_stl::rotate(first, middle, last);
+    }
+
+    // 把较长一段从中间切开，在另一段中二分出对应的位置，交换中间两块后两侧分别归并
+    template <class BidirIter, class Distance, class Compare>
+    void __merge_cut(BidirIter first, BidirIter middle, BidirIter last, Distance len1, Distance len2,
+                     BidirIter& first_cut, BidirIter& second_cut, Distance& len11, Distance& len22, Compare comp){
+        first_cut = first;
+        second_cut = middle;
+        if (len1 > len2){
+            len11 = len1 / 2;
+            pocket_stl::advance(first_cut, len11);
+            second_cut = pocket_stl::lower_bound(middle, last, *first_cut, comp);
+            len22 = pocket_stl::distance(middle, second_cut);
+        }
+        else{
+            len22 = len2 / 2;
+            pocket_stl::advance(second_cut, len22);
+            first_cut = pocket_stl::upper_bound(first, middle, *second_cut, comp);
+            len11 = pocket_stl::distance(first, first_cut);
+        }
+    }
+
+    // 没有缓冲区时只靠 rotate 归并，O(nlogn)
+    template <class BidirIter, class Distance, class Compare>
+    void __merge_without_buffer(BidirIter first, BidirIter middle, BidirIter last,
+                                Distance len1, Distance len2, Compare comp){
+        if (len1 == 0 || len2 == 0) return;
+        if (len1 + len2 == 2){
+            if (comp(*middle, *first)) pocket_stl::__iter_swap(first, middle);
+            return;
+        }
+        BidirIter first_cut, second_cut;
+        Distance len11 = 0, len22 = 0;
+        pocket_stl::__merge_cut(first, middle, last, len1, len2, first_cut, second_cut, len11, len22, comp);
+        BidirIter new_middle = pocket_stl::rotate(first_cut, middle, second_cut);
+        pocket_stl::__merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+        pocket_stl::__merge_without_buffer(new_middle, second_cut, last, len1 - len11, len2 - len22, comp);
+    }
+
+    // 较短的一段放得进缓冲区时一趟归并完成，否则切开后递归
+    template <class BidirIter, class Distance, class Pointer, class Compare>
+    void __merge_adaptive(BidirIter first, BidirIter middle, BidirIter last, Distance len1, Distance len2,
+                          Pointer buffer, Distance buffer_size, Compare comp){
+        if (len1 <= len2 && len1 <= buffer_size){
+            Pointer buffer_end = pocket_stl::move(first, middle, buffer);
+            pocket_stl::__move_merge_forward(buffer, buffer_end, middle, last, first, comp);
+        }
+        else if (len2 <= buffer_size){
+            Pointer buffer_end = pocket_stl::move(middle, last, buffer);
+            pocket_stl::__move_merge_backward(first, middle, buffer, buffer_end, last, comp);
+        }
+        else{
+            BidirIter first_cut, second_cut;
+            Distance len11 = 0, len22 = 0;
+            pocket_stl::__merge_cut(first, middle, last, len1, len2, first_cut, second_cut, len11, len22, comp);
+            BidirIter new_middle = pocket_stl::__rotate_adaptive(first_cut, middle, second_cut,
+                                                                 len1 - len11, len22, buffer, buffer_size);
+            pocket_stl::__merge_adaptive(first, first_cut, new_middle, len11, len22, buffer, buffer_size, comp);
+            pocket_stl::__merge_adaptive(new_middle, second_cut, last, len1 - len11, len2 - len22,
+                                         buffer, buffer_size, comp);
+        }
+    }
+
+    // 缓冲区只需要较短一段的长度，申请不到时退回无缓冲区的归并
+    template <class BidirIter, class Compare>
+    void inplace_merge(BidirIter first, BidirIter middle, BidirIter last, Compare comp){
+        typedef typename iterator_traits<BidirIter>::value_type       T;
+        typedef typename iterator_traits<BidirIter>::difference_type  Distance;
+        if (first == middle || middle == last) return;
+        const Distance len1 = pocket_stl::distance(first, middle);
+        const Distance len2 = pocket_stl::distance(middle, last);
+        temporary_buffer<BidirIter, T> buf(len1 <= len2 ? first : middle, len1 <= len2 ? middle : last);
+        if (buf.begin() == nullptr){
+            pocket_stl::__merge_without_buffer(first, middle, last, len1, len2, comp);
+        }
+        else{
+            pocket_stl::__merge_adaptive(first, middle, last, len1, len2, buf.begin(), Distance(buf.size()), comp);
+        }
+    }
+
+    template <class BidirIter>
+    void inplace_merge(BidirIter first, BidirIter middle, BidirIter last){
+        pocket_stl::inplace_merge(first, middle, last, __less());
+    }
+
+    /**************************** stable_sort ****************************/
+    // 先对每 7 个元素一组做插入排序，再在区间与缓冲区之间来回归并，每趟把有序段的长度翻倍
+    enum { __STABLE_SORT_CHUNK = 7, __INPLACE_STABLE_SORT_THRESHOLD = 15 };
+
+    template <class RandomIter, class Distance, class Compare>
+    void __chunk_insertion_sort(RandomIter first, RandomIter last, Distance chunk, Compare comp){
+        while (last - first >= chunk){
+            pocket_stl::__insertion_sort(first, first + chunk, comp);
+            first += chunk;
+        }
+        pocket_stl::__insertion_sort(first, last, comp);
+    }
+
+    // 把 [first, last) 中长度为 step 的相邻有序段两两归并到 result
+    template <class RandomIter1, class RandomIter2, class Distance, class Compare>
+    void __merge_sort_loop(RandomIter1 first, RandomIter1 last, RandomIter2 result, Distance step, Compare comp){
+        const Distance two_step = 2 * step;
+        while (last - first >= two_step){
+            result = pocket_stl::__move_merge(first, first + step, first + step, first + two_step, result, comp);
+            first += two_step;
+        }
+        step = last - first < step ? Distance(last - first) : step;
+        pocket_stl::__move_merge(first, first + step, first + step, last, result, comp);
+    }
+
+    // 缓冲区至少与区间等长
+    template <class RandomIter, class Pointer, class Compare>
+    void __merge_sort_with_buffer(RandomIter first, RandomIter last, Pointer buffer, Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        const Distance len = last - first;
+        const Pointer buffer_last = buffer + len;
+        Distance step = __STABLE_SORT_CHUNK;
+        pocket_stl::__chunk_insertion_sort(first, last, step, comp);
+        while (step < len){
+            pocket_stl::__merge_sort_loop(first, last, buffer, step, comp);
+            step *= 2;
+            pocket_stl::__merge_sort_loop(buffer, buffer_last, first, step, comp);
+            step *= 2;
+        }
+    }
+
+    // 两半各自放得进缓冲区时直接排序，否则继续二分，最后自适应地归并两半
+    template <class RandomIter, class Pointer, class Distance, class Compare>
+    void __stable_sort_adaptive(RandomIter first, RandomIter last, Pointer buffer, Distance buffer_size, Compare comp){
+        const Distance len = (last - first + 1) / 2;
+        const RandomIter middle = first + len;
+        if (len > buffer_size){
+            pocket_stl::__stable_sort_adaptive(first, middle, buffer, buffer_size, comp);
+            pocket_stl::__stable_sort_adaptive(middle, last, buffer, buffer_size, comp);
+        }
+        else{
+            pocket_stl::__merge_sort_with_buffer(first, middle, buffer, comp);
+            pocket_stl::__merge_sort_with_buffer(middle, last, buffer, comp);
+        }
+        pocket_stl::__merge_adaptive(first, middle, last, Distance(middle - first), Distance(last - middle),
+                                     buffer, buffer_size, comp);
+    }
+
+    template <class RandomIter, class Compare>
+    void __inplace_stable_sort(RandomIter first, RandomIter last, Compare comp){
+        if (last - first < __INPLACE_STABLE_SORT_THRESHOLD){
+            pocket_stl::__insertion_sort(first, last, comp);
+            return;
+        }
+        const RandomIter middle = first + (last - first) / 2;
+        pocket_stl::__inplace_stable_sort(first, middle, comp);
+        pocket_stl::__inplace_stable_sort(middle, last, comp);
+        pocket_stl::__merge_without_buffer(first, middle, last, middle - first, last - middle, comp);
+    }
+
+    // 缓冲区申请一半长度即可；申请不到时退回 O(nlog²n) 的原地归并排序
+    template <class RandomIter, class Compare>
+    void stable_sort(RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type       T;
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        if (last - first < 2) return;
+        temporary_buffer<RandomIter, T> buf(first, first + (last - first + 1) / 2);
+        if (buf.begin() == nullptr){
+            pocket_stl::__inplace_stable_sort(first, last, comp);
+        }
+        else{
+            pocket_stl::__stable_sort_adaptive(first, last, buf.begin(), Distance(buf.size()), comp);
+        }
+    }
+
+    template <class RandomIter>
+    void stable_sort(RandomIter first, RandomIter last){
+        pocket_stl::stable_sort(first, last, __less());
+    }
+
+    /**************************** set operations ****************************/
+    // 两段长度相差超过 __GALLOP_RATIO 倍时，逐个取较短一段的元素，在较长一段中从上次的位置起倍增步长再二分，
+    // 代价为 O(m log(n/m))；长度相近时逐个归并。两段都是连续存放、没有重复元素的 32 位整数且使用默认比较时，求交使用 SIMD 分组比较
+    enum { __GALLOP_RATIO = 24 };
+
+    // 从 first 开始以 1、2、4…的步长向后试探，找到包含答案的一段后再二分
+    template <class RandomIter, class T, class Compare>
+    RandomIter __gallop_lower_bound(RandomIter first, RandomIter last, const T& value, Compare& comp){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        if (first == last || !comp(*first, value)) return first;
+        const Distance len = last - first;
+        Distance lo = 0, step = 1, hi = 1;
+        while (hi < len && comp(*(first + hi), value)){
+            lo = hi;
+            step *= 2;
+            hi = lo + step;
+        }
+        if (hi > len) hi = len;
+        return pocket_stl::lower_bound(first + (lo + 1), first + hi, value, comp);
+    }
+
+    template <class RandomIter1, class RandomIter2>
+    inline bool __should_gallop(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2){
+        const auto len1 = last1 - first1;
+        const auto len2 = last2 - first2;
+        return len1 > len2 * __GALLOP_RATIO || len2 > len1 * __GALLOP_RATIO;
+    }
+
+    /**************************** set_intersection ****************************/
+    // 相等的元素取第一段的，共出现 min(m, n) 次
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_intersection_merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                        OutputIter result, Compare& comp){
+        while (first1 != last1 && first2 != last2){
+            if (comp(*first1, *first2)){
+                ++first1;
+            }
+            else if (comp(*first2, *first1)){
+                ++first2;
+            }
+            else{
+                *result = *first1;
+                ++result;
+                ++first1;
+                ++first2;
+            }
+        }
+        return result;
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    OutputIter __set_intersection_gallop(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                         OutputIter result, Compare& comp){
+        if (last1 - first1 < last2 - first2){
+            for (; first1 != last1; ++first1){
+                first2 = pocket_stl::__gallop_lower_bound(first2, last2, *first1, comp);
+                if (first2 == last2) break;
+                if (!comp(*first1, *first2)){
+                    *result = *first1;
+                    ++result;
+                    ++first2;
+                }
+            }
+        }
+        else{
+            for (; first2 != last2; ++first2){
+                first1 = pocket_stl::__gallop_lower_bound(first1, last1, *first2, comp);
+                if (first1 == last1) break;
+                if (!comp(*first2, *first1)){
+                    *result = *first1;
+                    ++result;
+                    ++first1;
+                }
+            }
+        }
+        return result;
+    }
+
+    // 输入输出都是同一种 32 位整数的指针，并且比较只是整数的大小比较
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    struct __is_simd_intersectable : public std::integral_constant<bool,
+        std::is_pointer<InputIter1>::value && std::is_pointer<InputIter2>::value && std::is_pointer<OutputIter>::value &&
+        std::is_same<typename iterator_traits<InputIter1>::value_type, typename iterator_traits<InputIter2>::value_type>::value &&
+        std::is_same<typename iterator_traits<InputIter1>::value_type, typename iterator_traits<OutputIter>::value_type>::value &&
+        std::is_integral<typename iterator_traits<InputIter1>::value_type>::value &&
+        sizeof(typename iterator_traits<InputIter1>::value_type) == 4 &&
+        __is_default_compare<Compare>::value> {};
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    inline OutputIter __set_intersection_dense(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                               OutputIter result, Compare& comp, std::false_type){
+        return pocket_stl::__set_intersection_merge(first1, last1, first2, last2, result, comp);
+    }
+
+    // 分组比较不能正确处理重复元素，有重复时退回逐个归并
+    template <class Pointer1, class Pointer2, class OutputPointer, class Compare>
+    OutputPointer __set_intersection_dense(Pointer1 first1, Pointer1 last1, Pointer2 first2, Pointer2 last2,
+                                           OutputPointer result, Compare& comp, std::true_type){
+        const size_t len1 = static_cast<size_t>(last1 - first1);
+        const size_t len2 = static_cast<size_t>(last2 - first2);
+        if (pocket_stl::__simd_has_adjacent_equal32(first1, len1) || pocket_stl::__simd_has_adjacent_equal32(first2, len2)){
+            return pocket_stl::__set_intersection_merge(first1, last1, first2, last2, result, comp);
+        }
+        size_t i = 0, j = 0;
+        result += pocket_stl::__simd_intersect32(first1, len1, first2, len2, result, i, j, comp);
+        return pocket_stl::__set_intersection_merge(first1 + i, last1, first2 + j, last2, result, comp);
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare, class Category1, class Category2>
+    inline OutputIter __set_intersection(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                         OutputIter result, Compare& comp, Category1, Category2){
+        return pocket_stl::__set_intersection_dense(first1, last1, first2, last2, result, comp,
+            std::integral_constant<bool, __is_simd_intersectable<InputIter1, InputIter2, OutputIter, Compare>::value>());
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    inline OutputIter __set_intersection(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                         OutputIter result, Compare& comp,
+                                         random_access_iterator_tag, random_access_iterator_tag){
+        if (pocket_stl::__should_gallop(first1, last1, first2, last2)){
+            return pocket_stl::__set_intersection_gallop(first1, last1, first2, last2, result, comp);
+        }
+        return pocket_stl::__set_intersection_dense(first1, last1, first2, last2, result, comp,
+            std::integral_constant<bool, __is_simd_intersectable<RandomIter1, RandomIter2, OutputIter, Compare>::value>());
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter set_intersection(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                OutputIter result, Compare comp){
+        return pocket_stl::__set_intersection(first1, last1, first2, last2, result, comp,
+                                              iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter set_intersection(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result){
+        return pocket_stl::set_intersection(first1, last1, first2, last2, result, __less());
+    }
+
+    /**************************** set_union ****************************/
+    // 相等的元素先取第一段的，共出现 max(m, n) 次
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_union_merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                 OutputIter result, Compare& comp){
+        for (; first1 != last1 && first2 != last2; ++result){
+            if (comp(*first1, *first2)){
+                *result = *first1;
+                ++first1;
+            }
+            else if (comp(*first2, *first1)){
+                *result = *first2;
+                ++first2;
+            }
+            else{
+                *result = *first1;
+                ++first1;
+                ++first2;
+            }
+        }
+        return pocket_stl::copy(first2, last2, pocket_stl::copy(first1, last1, result));
+    }
+
+    // 较长一段中夹在两个相邻的较短一段元素之间的部分整段复制
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    OutputIter __set_union_gallop(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                  OutputIter result, Compare& comp){
+        if (last1 - first1 < last2 - first2){
+            for (; first1 != last1; ++first1, ++result){
+                RandomIter2 pos = pocket_stl::__gallop_lower_bound(first2, last2, *first1, comp);
+                result = pocket_stl::copy(first2, pos, result);
+                first2 = pos;
+                *result = *first1;
+                if (first2 != last2 && !comp(*first1, *first2)) ++first2;
+            }
+        }
+        else{
+            for (; first2 != last2; ++first2, ++result){
+                RandomIter1 pos = pocket_stl::__gallop_lower_bound(first1, last1, *first2, comp);
+                result = pocket_stl::copy(first1, pos, result);
+                first1 = pos;
+                if (first1 != last1 && !comp(*first2, *first1)){
+                    *result = *first1;
+                    ++first1;
+                }
+                else{
+                    *result = *first2;
+                }
+            }
+        }
+        return pocket_stl::copy(first2, last2, pocket_stl::copy(first1, last1, result));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare, class Category1, class Category2>
+    inline OutputIter __set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                  OutputIter result, Compare& comp, Category1, Category2){
+        return pocket_stl::__set_union_merge(first1, last1, first2, last2, result, comp);
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    inline OutputIter __set_union(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                  OutputIter result, Compare& comp, random_access_iterator_tag, random_access_iterator_tag){
+        if (pocket_stl::__should_gallop(first1, last1, first2, last2)){
+            return pocket_stl::__set_union_gallop(first1, last1, first2, last2, result, comp);
+        }
+        return pocket_stl::__set_union_merge(first1, last1, first2, last2, result, comp);
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                         OutputIter result, Compare comp){
+        return pocket_stl::__set_union(first1, last1, first2, last2, result, comp,
+                                       iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result){
+        return pocket_stl::set_union(first1, last1, first2, last2, result, __less());
+    }
+
+    /**************************** set_difference ****************************/
+    // 第一段中去掉与第二段相等的元素，每个第二段的元素只抵消一个
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_difference_merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                      OutputIter result, Compare& comp){
+        while (first1 != last1 && first2 != last2){
+            if (comp(*first1, *first2)){
+                *result = *first1;
+                ++result;
+                ++first1;
+            }
+            else if (comp(*first2, *first1)){
+                ++first2;
+            }
+            else{
+                ++first1;
+                ++first2;
+            }
+        }
+        return pocket_stl::copy(first1, last1, result);
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    OutputIter __set_difference_gallop(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                       OutputIter result, Compare& comp){
+        if (last1 - first1 < last2 - first2){
+            for (; first1 != last1; ++first1){
+                first2 = pocket_stl::__gallop_lower_bound(first2, last2, *first1, comp);
+                if (first2 != last2 && !comp(*first1, *first2)){
+                    ++first2;
+                }
+                else{
+                    *result = *first1;
+                    ++result;
+                }
+            }
+            return result;
+        }
+        for (; first2 != last2 && first1 != last1; ++first2){
+            RandomIter1 pos = pocket_stl::__gallop_lower_bound(first1, last1, *first2, comp);
+            result = pocket_stl::copy(first1, pos, result);
+            first1 = pos;
+            if (first1 != last1 && !comp(*first2, *first1)) ++first1;
+        }
+        return pocket_stl::copy(first1, last1, result);
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare, class Category1, class Category2>
+    inline OutputIter __set_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                                       OutputIter result, Compare& comp, Category1, Category2){
+        return pocket_stl::__set_difference_merge(first1, last1, first2, last2, result, comp);
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    inline OutputIter __set_difference(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                       OutputIter result, Compare& comp, random_access_iterator_tag, random_access_iterator_tag){
+        if (pocket_stl::__should_gallop(first1, last1, first2, last2)){
+            return pocket_stl::__set_difference_gallop(first1, last1, first2, last2, result, comp);
+        }
+        return pocket_stl::__set_difference_merge(first1, last1, first2, last2, result, comp);
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter set_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                              OutputIter result, Compare comp){
+        return pocket_stl::__set_difference(first1, last1, first2, last2, result, comp,
+                                            iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter set_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result){
+        return pocket_stl::set_difference(first1, last1, first2, last2, result, __less());
+    }
+
+    /**************************** includes ****************************/
+    // 第二段是否是第一段的子序列（按重数计）
+    template <class InputIter1, class InputIter2, class Compare>
+    bool __includes_merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, Compare& comp){
+        for (; first2 != last2; ++first1){
+            if (first1 == last1 || comp(*first2, *first1)) return false;
+            if (!comp(*first1, *first2)) ++first2;
+        }
+        return true;
+    }
+
+    template <class RandomIter1, class RandomIter2, class Compare>
+    bool __includes_gallop(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2, Compare& comp){
+        if (last1 - first1 < last2 - first2) return false;
+        for (; first2 != last2; ++first2, ++first1){
+            first1 = pocket_stl::__gallop_lower_bound(first1, last1, *first2, comp);
+            if (first1 == last1 || comp(*first2, *first1)) return false;
+        }
+        return true;
+    }
+
+    template <class InputIter1, class InputIter2, class Compare, class Category1, class Category2>
+    inline bool __includes(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                           Compare& comp, Category1, Category2){
+        return pocket_stl::__includes_merge(first1, last1, first2, last2, comp);
+    }
+
+    template <class RandomIter1, class RandomIter2, class Compare>
+    inline bool __includes(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                           Compare& comp, random_access_iterator_tag, random_access_iterator_tag){
+        if (pocket_stl::__should_gallop(first1, last1, first2, last2)){
+            return pocket_stl::__includes_gallop(first1, last1, first2, last2, comp);
+        }
+        return pocket_stl::__includes_merge(first1, last1, first2, last2, comp);
+    }
+
+    template <class InputIter1, class InputIter2, class Compare>
+    bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, Compare comp){
+        return pocket_stl::__includes(first1, last1, first2, last2, comp, iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIter1, class InputIter2>
+    bool includes(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2){
+        return pocket_stl::includes(first1, last1, first2, last2, __less());
+    }
+
+    /**************************** radix sort ****************************/
+    enum { __RADIX_SORT_THRESHOLD = 256 };  // 小于该长度的区间比较排序更快
+
+    template <size_t Size> struct __radix_unsigned;
+    template <> struct __radix_unsigned<1> { typedef unsigned char      type; };
+    template <> struct __radix_unsigned<2> { typedef unsigned short     type; };
+    template <> struct __radix_unsigned<4> { typedef unsigned int       type; };
+    template <> struct __radix_unsigned<8> { typedef unsigned long long type; };
+
+    // 把键映射为同样宽度的无符号整数，映射前后的大小顺序一致
+    // 有符号整数翻转符号位；浮点数为正时翻转符号位，为负时翻转所有位（-0.0 排在 +0.0 之前，NaN 按符号排在两端）
+    template <class Key, class = void>
+    struct __radix_traits;
+
+    template <class Key>
+    struct __radix_traits<Key, typename std::enable_if<std::is_integral<Key>::value>::type>{
+        typedef typename __radix_unsigned<sizeof(Key)>::type type;
+        static type to_unsigned(Key k) noexcept{
+            const type sign = std::is_signed<Key>::value ? type(type(1) << (sizeof(Key) * 8 - 1)) : type(0);
+            return static_cast<type>(static_cast<type>(k) ^ sign);
+        }
+    };
+
+    template <class Key>
+    struct __radix_traits<Key, typename std::enable_if<std::is_floating_point<Key>::value &&
+                                                       (sizeof(Key) == 4 || sizeof(Key) == 8)>::type>{
+        typedef typename __radix_unsigned<sizeof(Key)>::type type;
+        static type to_unsigned(Key k) noexcept{
+            type bits;
+            std::memcpy(&bits, &k, sizeof(Key));
+            const type sign = type(1) << (sizeof(Key) * 8 - 1);
+            return (bits & sign) ? type(~bits) : type(bits | sign);
+        }
+    };
+
+    template <class T>
+    struct __radix_identity{
+        const T& operator()(const T& x) const { return x; }
+    };
+
+    // 按映射后的键比较，区间较短或申请不到缓冲区时使用
+    template <class KeyFn>
+    struct __radix_key_less{
+        KeyFn key_fn;
+        template <class T>
+        bool operator()(const T& x, const T& y) const{
+            typedef typename std::decay<decltype(key_fn(x))>::type Key;
+            return __radix_traits<Key>::to_unsigned(key_fn(x)) < __radix_traits<Key>::to_unsigned(key_fn(y));
+        }
+    };
+
+    // 把 src 开始的 n 个元素按第 shift 位开始的数字分配到 dst，offsets 为各数字的起始位置
+    // construct 为 true 时 dst 是未初始化的缓冲区，在其上构造元素
+    template <class SrcIter, class DstIter, class KeyFn>
+    void __radix_scatter(SrcIter src, size_t n, DstIter dst, size_t* offsets, unsigned shift, size_t mask,
+                         KeyFn& key_fn, bool construct){
+        typedef typename std::decay<decltype(key_fn(*src))>::type Key;
+        for (size_t i = 0; i < n; ++i, ++src){
+            const size_t digit = (__radix_traits<Key>::to_unsigned(key_fn(*src)) >> shift) & mask;
+            DstIter pos = dst + offsets[digit]++;
+            if (construct) pocket_stl::construct(&*pos, std::move(*src));
+            else           *pos = std::move(*src);
+        }
+    }
+
+    // 持有临时缓冲区与直方图，异常离开时析构缓冲区中已构造的元素并释放空间
+    template <class T>
+    struct __radix_storage{
+        std::pair<T*, ptrdiff_t>    buf;
+        size_t*                     counts;
+        size_t                      constructed;    // 缓冲区开头已构造的元素个数
+
+        __radix_storage(ptrdiff_t len, size_t count_size)
+            : buf(pocket_stl::get_temporary_buffer<T>(len)), counts(nullptr), constructed(0){
+            try{
+                counts = new size_t[count_size]();
+            }
+            catch(...){
+                pocket_stl::release_temporary_buffer(buf.first);
+                throw;
+            }
+        }
+        ~__radix_storage(){
+            pocket_stl::destroy(buf.first, buf.first + constructed);
+            pocket_stl::release_temporary_buffer(buf.first);
+            delete[] counts;
+        }
+        __radix_storage(const __radix_storage&) = delete;
+        __radix_storage& operator=(const __radix_storage&) = delete;
+    };
+
+    template <class RandomIter, class KeyFn>
+    void __radix_sort(RandomIter first, RandomIter last, KeyFn key_fn){
+        typedef typename iterator_traits<RandomIter>::value_type     T;
+        typedef typename std::decay<decltype(key_fn(*first))>::type   Key;
+        typedef typename __radix_traits<Key>::type                    U;
+        // 32 / 64 位的键每趟处理 11 位，比 8 位少两到三趟；更窄的键按字节处理
+        enum { BITS = sizeof(U) >= 4 ? 11 : 8 };
+        enum { RADIX = 1 << BITS };
+        enum { PASSES = (sizeof(U) * 8 + BITS - 1) / BITS };
+
+        const ptrdiff_t len = last - first;
+        if (len < 2) return;
+        if (len < __RADIX_SORT_THRESHOLD){
+            pocket_stl::__insertion_sort(first, last, __radix_key_less<KeyFn>{ key_fn });
+            return;
+        }
+        // 移动可能抛出异常时分配到一半的数据无法恢复，改用比较排序
+        if (!std::is_nothrow_move_constructible<T>::value || !std::is_nothrow_move_assignable<T>::value){
+            pocket_stl::stable_sort(first, last, __radix_key_less<KeyFn>{ key_fn });
+            return;
+        }
+        // 直方图共 (PASSES + 1) * RADIX 个计数，64 位键约 110 KB，放在堆上以免占用工作线程的栈
+        __radix_storage<T> storage(len, (PASSES + 1) * RADIX);
+        if (storage.buf.second < len){
+            pocket_stl::stable_sort(first, last, __radix_key_less<KeyFn>{ key_fn });
+            return;
+        }
+        T* const buffer = storage.buf.first;
+        size_t* const counts = storage.counts;
+        size_t* const offsets = counts + PASSES * RADIX;
+        const size_t n = static_cast<size_t>(len);
+
+        // 一次遍历统计所有趟的直方图
+        RandomIter it = first;
+        for (size_t i = 0; i < n; ++i, ++it){
+            const U u = __radix_traits<Key>::to_unsigned(key_fn(*it));
+            for (unsigned p = 0; p < PASSES; ++p){
+                ++counts[p * RADIX + ((u >> (p * BITS)) & (RADIX - 1))];
+            }
+        }
+
+        // 元素需要析构时先按顺序移入缓冲区，已构造的总是缓冲区的前缀，
+        // 之后各趟都是赋值；平凡析构的元素直接在第一趟分配时构造，异常时无需析构
+        bool in_buffer = false;     // 当前数据位于缓冲区中
+        bool constructed = false;   // 缓冲区中已经构造了元素
+        if (!std::is_trivially_destructible<T>::value){
+            it = first;
+            for (; storage.constructed < n; ++storage.constructed, ++it){
+                pocket_stl::construct(buffer + storage.constructed, std::move(*it));
+            }
+            in_buffer = true;
+            constructed = true;
+        }
+
+        // 所有元素在这一位上的数字都相同时，这一趟不改变顺序，直接跳过
+        const U u0 = __radix_traits<Key>::to_unsigned(key_fn(in_buffer ? *buffer : *first));
+        for (unsigned p = 0; p < PASSES; ++p){
+            const unsigned shift = p * BITS;
+            const size_t* count = counts + p * RADIX;
+            if (count[(u0 >> shift) & (RADIX - 1)] == n) continue;
+            size_t sum = 0;
+            for (size_t d = 0; d < RADIX; ++d){
+                offsets[d] = sum;
+                sum += count[d];
+            }
+            if (in_buffer){
+                pocket_stl::__radix_scatter(buffer, n, first, offsets, shift, RADIX - 1, key_fn, false);
+            }
+            else{
+                pocket_stl::__radix_scatter(first, n, buffer, offsets, shift, RADIX - 1, key_fn, !constructed);
+                constructed = true;
+            }
+            in_buffer = !in_buffer;
+        }
+
+        if (in_buffer) pocket_stl::move(buffer, buffer + n, first);
+    }
+
+    // 按元素自身排序，value_type 为整数或 float / double
+    template <class RandomIter>
+    void radix_sort(RandomIter first, RandomIter last){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        pocket_stl::__radix_sort(first, last, __radix_identity<T>());
+    }
+
+    // 按 key_fn(元素) 返回的整数或 float / double 排序，适合按某个字段排序记录
+    template <class RandomIter, class KeyFn>
+    void radix_sort_by_key(RandomIter first, RandomIter last, KeyFn key_fn){
+        pocket_stl::__radix_sort(first, last, key_fn);
+    }
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef _POCKET_ALIGNED_ALLOCATOR_H_
+#define _POCKET_ALIGNED_ALLOCATOR_H_
+
+/*
+** aligned_allocator
+** 按 Align 字节对齐分配空间，Align 取 cache line（64）可避免相邻容器之间的 false sharing，
+** 取 32 / 64 可让 SIMD 循环使用对齐的 load / store，取 4096 得到按页对齐的缓冲区
+** 支持 aligned operator new（C++17）时直接使用它，否则多申请 Align 字节自行对齐
+*/
+
+#include <cstddef>
+#include <climits>
+#include <new>
+#include "construct.h"
+#include "allocator.h"
+
+namespace pocket_stl{
+
+    template <size_t Align>
+    struct __aligned_storage{
+        static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of two");
+
+        // 大小同样上调到 Align 的倍数，块的尾部不会与其他分配共享同一条 cache line
+        static constexpr size_t round_up(size_t bytes) noexcept{
+            return (bytes + Align - 1) & ~(Align - 1);
+        }
+
+#if defined(__cpp_aligned_new)
+        static void* allocate(size_t bytes){
+            return ::operator new(bytes, std::align_val_t(Align));
+        }
+        static void deallocate(void* p) noexcept{
+            ::operator delete(p, std::align_val_t(Align));
+        }
+#else
+        // 在返回地址的前一个指针宽度处记录 ::operator new 得到的原始地址
+        static void* allocate(size_t bytes){
+            char* raw = static_cast<char*>(::operator new(bytes + Align + sizeof(void*)));
+            const size_t addr = reinterpret_cast<size_t>(raw + sizeof(void*));
+            char* p = reinterpret_cast<char*>((addr + Align - 1) & ~(Align - 1));
+            reinterpret_cast<void**>(p)[-1] = raw;
+            return p;
+        }
+        static void deallocate(void* p) noexcept{
+            ::operator delete(static_cast<void**>(p)[-1]);
+        }
+#endif
+    };
+
+    template <class T, size_t Align = 64>
+    class aligned_allocator{
+        static_assert(Align >= alignof(T), "Align must not be weaker than alignof(T)");
+
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        static constexpr size_t alignment() noexcept { return Align; }
+
+        // rebind 后保持相同的对齐，deque 的 map 与 buffer 都按 Align 对齐
+        template <class U>
+        struct rebind{
+            typedef aligned_allocator<U, (Align > alignof(U) ? Align : alignof(U))> other;
+        };
+
+        aligned_allocator() noexcept {}
+        template <class U, size_t A>
+        aligned_allocator(const aligned_allocator<U, A>&) noexcept {}
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return size_type(UINT_MAX / sizeof(T)); }
+
+        pointer allocate(size_type n){
+            if (n == 0) return nullptr;
+            return static_cast<pointer>(__aligned_storage<Align>::allocate(__aligned_storage<Align>::round_up(n * sizeof(T))));
+        }
+        // 为了对齐而上调出来的尾部同样可用
+        allocation_result<pointer> allocate_at_least(size_type n){
+            if (n == 0) return { nullptr, 0 };
+            const size_t bytes = __aligned_storage<Align>::round_up(n * sizeof(T));
+            return { static_cast<pointer>(__aligned_storage<Align>::allocate(bytes)), bytes / sizeof(T) };
+        }
+        void deallocate(pointer p, size_type){
+            if (p != nullptr) __aligned_storage<Align>::deallocate(p);
+        }
+        void deallocate(pointer p) { deallocate(p, 1); }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+    };
+
+    template <class T, size_t A, class U, size_t B>
+    bool operator==(const aligned_allocator<T, A>&, const aligned_allocator<U, B>&) noexcept { return true; }
+
+    template <class T, size_t A, class U, size_t B>
+    bool operator!=(const aligned_allocator<T, A>&, const aligned_allocator<U, B>&) noexcept { return false; }
+
+}
+
+#endif
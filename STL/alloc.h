@@ -3,10 +3,414 @@
 
 /*
 ** 以内存池的方式进行内存分配
+** 参考 SGI STL 的二级配置器：
+** 小于等于 __MAX_BYTES 的区块以 __ALIGN 字节为步长划分为 __NFREELISTS 个 size class，
+** 每个 size class 维护一条 free list，free list 为空时从内存池中批量切出区块补充（refill），
+** 内存池耗尽时再向系统申请一大块 chunk。大于 __MAX_BYTES 的区块直接交给 ::operator new。
+**
+** 全局 free list 由一把锁保护，作为各线程共享的 depot；
+** 每个线程在其前面有一层 __pool_thread_cache，命中时不加锁也不使用原子操作，
+** 只有本地缓存为空或过满时才整批地与 depot 交换区块。
 */
 
-namespace pocktet_stl{
-    
+#include <cstddef>
+#include <climits>
+#include <new>
+#include <mutex>
+#include "construct.h"
+#include "allocator.h"
+#include "aligned_allocator.h"
+
+namespace pocket_stl{
+
+    template <int inst>
+    class __pool_thread_cache;
+
+    template <int inst>
+    class __pool_alloc_template{
+    private:
+        friend class __pool_thread_cache<inst>;
+
+        enum { __ALIGN = 8 };                               // 小型区块的上调边界
+        enum { __MAX_BYTES = 128 };                         // 小型区块的上限
+        enum { __NFREELISTS = __MAX_BYTES / __ALIGN };      // free list 个数
+        enum { __NOBJS = 20 };                              // 每次 refill 默认切出的区块数
+
+        // free list 的节点，未分配时借用区块本身的空间存放 next 指针
+        union obj{
+            union obj* free_list_link;
+            char client_data[1];
+        };
+
+        static obj*         free_list[__NFREELISTS];
+        static char*        start_free;                     // 内存池起始位置
+        static char*        end_free;                       // 内存池结束位置
+        static size_t       heap_size;                      // 累计向系统申请的大小
+        static std::mutex   pool_lock;
+
+    public:
+        static void*    allocate(size_t n);
+        static void     deallocate(void* p, size_t n);
+
+        static constexpr size_t max_bytes() noexcept { return __MAX_BYTES; }
+        static constexpr size_t alignment() noexcept { return __ALIGN; }
+        // 申请 bytes 字节时实际得到的区块大小，小型区块会被上调至 __ALIGN 的倍数
+        static constexpr size_t good_size(size_t bytes) noexcept{
+            return bytes > __MAX_BYTES ? bytes : round_up(bytes);
+        }
+
+    private:
+        // 将 bytes 上调至 __ALIGN 的倍数
+        static constexpr size_t round_up(size_t bytes) noexcept{
+            return (bytes + __ALIGN - 1) & ~(static_cast<size_t>(__ALIGN) - 1);
+        }
+        // 根据区块大小决定使用第几号 free list，从 0 开始
+        static constexpr size_t freelist_index(size_t bytes) noexcept{
+            return (bytes + __ALIGN - 1) / __ALIGN - 1;
+        }
+
+        static void*    refill(size_t n);                   // 返回一个大小为 n 的区块，并可能补充其他区块到 free list
+        static char*    chunk_alloc(size_t size, int& nobjs);   // 从内存池中取出 nobjs 个大小为 size 的区块
+
+        // 供线程缓存整批存取，n 已上调至 __ALIGN 的倍数
+        static obj*     allocate_batch(size_t n, int& nobjs);   // 取出至多 nobjs 个区块，以链表形式返回
+        static void     deallocate_batch(obj* first, obj* last, size_t n);  // 归还链表 [first, last]
+    };
+
+    template <int inst>
+    typename __pool_alloc_template<inst>::obj*
+    __pool_alloc_template<inst>::free_list[__pool_alloc_template<inst>::__NFREELISTS] = {};
+
+    template <int inst>
+    char* __pool_alloc_template<inst>::start_free = nullptr;
+
+    template <int inst>
+    char* __pool_alloc_template<inst>::end_free = nullptr;
+
+    template <int inst>
+    size_t __pool_alloc_template<inst>::heap_size = 0;
+
+    template <int inst>
+    std::mutex __pool_alloc_template<inst>::pool_lock;
+
+    template <int inst>
+    void* __pool_alloc_template<inst>::allocate(size_t n){
+        if (n > static_cast<size_t>(__MAX_BYTES)){
+            return ::operator new(n);
+        }
+        std::lock_guard<std::mutex> guard(pool_lock);
+        obj** my_free_list = free_list + freelist_index(n);
+        obj* result = *my_free_list;
+        if (result == nullptr){
+            return refill(round_up(n));
+        }
+        *my_free_list = result->free_list_link;
+        return result;
+    }
+
+    template <int inst>
+    void __pool_alloc_template<inst>::deallocate(void* p, size_t n){
+        if (p == nullptr) return;
+        if (n > static_cast<size_t>(__MAX_BYTES)){
+            ::operator delete(p);
+            return;
+        }
+        std::lock_guard<std::mutex> guard(pool_lock);
+        obj* q = static_cast<obj*>(p);
+        obj** my_free_list = free_list + freelist_index(n);
+        q->free_list_link = *my_free_list;
+        *my_free_list = q;
+    }
+
+    // 调用时已持有 pool_lock，n 已上调至 __ALIGN 的倍数
+    template <int inst>
+    void* __pool_alloc_template<inst>::refill(size_t n){
+        int nobjs = __NOBJS;
+        char* chunk = chunk_alloc(n, nobjs);
+        if (nobjs == 1) return chunk;
+
+        // 第一块交给客端，其余串接进 free list
+        obj** my_free_list = free_list + freelist_index(n);
+        obj* result = reinterpret_cast<obj*>(chunk);
+        obj* next_obj = reinterpret_cast<obj*>(chunk + n);
+        *my_free_list = next_obj;
+        for (int i = 1; ; ++i){
+            obj* current_obj = next_obj;
+            next_obj = reinterpret_cast<obj*>(reinterpret_cast<char*>(next_obj) + n);
+            if (nobjs - 1 == i){
+                current_obj->free_list_link = nullptr;
+                break;
+            }
+            current_obj->free_list_link = next_obj;
+        }
+        return result;
+    }
+
+    // 调用时已持有 pool_lock
+    template <int inst>
+    char* __pool_alloc_template<inst>::chunk_alloc(size_t size, int& nobjs){
+        size_t total_bytes = size * nobjs;
+        size_t bytes_left = end_free - start_free;
+        char* result;
+
+        if (bytes_left >= total_bytes){                 // 内存池剩余空间完全满足需求
+            result = start_free;
+            start_free += total_bytes;
+            return result;
+        }
+        else if (bytes_left >= size){                   // 至少满足一个区块
+            nobjs = static_cast<int>(bytes_left / size);
+            total_bytes = size * nobjs;
+            result = start_free;
+            start_free += total_bytes;
+            return result;
+        }
+
+        // 内存池连一个区块都无法提供，先把残余零头编入适当的 free list
+        if (bytes_left > 0){
+            obj** my_free_list = free_list + freelist_index(bytes_left);
+            reinterpret_cast<obj*>(start_free)->free_list_link = *my_free_list;
+            *my_free_list = reinterpret_cast<obj*>(start_free);
+        }
+
+        const size_t bytes_to_get = 2 * total_bytes + round_up(heap_size >> 4);
+        start_free = static_cast<char*>(::operator new(bytes_to_get, std::nothrow));
+        if (start_free == nullptr){
+            // 系统内存不足，尝试从尚有未用区块且区块足够大的 free list 中借一块回内存池
+            for (size_t i = size; i <= static_cast<size_t>(__MAX_BYTES); i += __ALIGN){
+                obj** my_free_list = free_list + freelist_index(i);
+                obj* p = *my_free_list;
+                if (p != nullptr){
+                    *my_free_list = p->free_list_link;
+                    start_free = reinterpret_cast<char*>(p);
+                    end_free = start_free + i;
+                    return chunk_alloc(size, nobjs);
+                }
+            }
+            end_free = nullptr;
+            start_free = static_cast<char*>(::operator new(bytes_to_get));  // 失败则抛出 bad_alloc
+        }
+        heap_size += bytes_to_get;
+        end_free = start_free + bytes_to_get;
+        return chunk_alloc(size, nobjs);
+    }
+
+    template <int inst>
+    typename __pool_alloc_template<inst>::obj*
+    __pool_alloc_template<inst>::allocate_batch(size_t n, int& nobjs){
+        std::lock_guard<std::mutex> guard(pool_lock);
+        obj** my_free_list = free_list + freelist_index(n);
+        obj* result = *my_free_list;
+        if (result != nullptr){
+            // depot 中已有空闲区块，摘下至多 nobjs 个
+            obj* last = result;
+            int count = 1;
+            for (; count < nobjs && last->free_list_link != nullptr; ++count){
+                last = last->free_list_link;
+            }
+            *my_free_list = last->free_list_link;
+            last->free_list_link = nullptr;
+            nobjs = count;
+            return result;
+        }
+
+        char* chunk = chunk_alloc(n, nobjs);
+        result = reinterpret_cast<obj*>(chunk);
+        obj* cur = result;
+        for (int i = 1; i < nobjs; ++i){
+            obj* next = reinterpret_cast<obj*>(chunk + i * n);
+            cur->free_list_link = next;
+            cur = next;
+        }
+        cur->free_list_link = nullptr;
+        return result;
+    }
+
+    template <int inst>
+    void __pool_alloc_template<inst>::deallocate_batch(obj* first, obj* last, size_t n){
+        std::lock_guard<std::mutex> guard(pool_lock);
+        obj** my_free_list = free_list + freelist_index(n);
+        last->free_list_link = *my_free_list;
+        *my_free_list = first;
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // __pool_thread_cache
+    // 每个线程每个 size class 一条本地 free list，分配与归还都只在本线程内进行
+    // 本地链表为空时从 depot 取一批（__BATCH 个），超过 __HIGH_WATER 时把一批还给 depot
+    // 线程结束时缓存中剩余的区块全部归还 depot
+    // 主线程的 thread_local 先于静态对象析构，静态容器析构时缓存可能已经不存在，
+    // 此时经由平凡析构的 __state 判断出来，直接加锁访问 depot
+
+    template <int inst>
+    class __pool_thread_cache{
+    private:
+        using depot = __pool_alloc_template<inst>;
+        using obj   = typename depot::obj;
+
+        enum { __NFREELISTS = depot::__NFREELISTS };
+        enum { __BATCH = depot::__NOBJS };
+        enum { __HIGH_WATER = 2 * __BATCH };
+
+        struct bin{
+            obj* head;
+            int  count;
+        };
+        bin bins[__NFREELISTS];
+
+    public:
+        __pool_thread_cache() noexcept{
+            for (int i = 0; i < __NFREELISTS; ++i){
+                bins[i].head = nullptr;
+                bins[i].count = 0;
+            }
+            __state() = __ALIVE;
+        }
+        ~__pool_thread_cache(){
+            __state() = __DESTROYED;
+            for (int i = 0; i < __NFREELISTS; ++i){
+                if (bins[i].head != nullptr){
+                    obj* last = bins[i].head;
+                    while (last->free_list_link != nullptr) last = last->free_list_link;
+                    depot::deallocate_batch(bins[i].head, last, (i + 1) * depot::__ALIGN);
+                }
+            }
+        }
+        __pool_thread_cache(const __pool_thread_cache&) = delete;
+        __pool_thread_cache& operator=(const __pool_thread_cache&) = delete;
+
+    private:
+        enum { __UNINITIALIZED, __ALIVE, __DESTROYED };
+
+        // 常量初始化且平凡析构，缓存析构之后仍然可以读取
+        static unsigned char& __state() noexcept{
+            static thread_local unsigned char state = __UNINITIALIZED;
+            return state;
+        }
+
+    public:
+        // 当前线程的缓存，已经析构时返回 nullptr
+        static __pool_thread_cache* local() noexcept{
+            if (__state() == __DESTROYED) return nullptr;
+            static thread_local __pool_thread_cache cache;
+            return &cache;
+        }
+
+        static void* allocate(size_t n){
+            if (n > static_cast<size_t>(depot::__MAX_BYTES)){
+                return ::operator new(n);
+            }
+            __pool_thread_cache* cache = local();
+            if (cache == nullptr) return depot::allocate(n);
+            bin& b = cache->bins[depot::freelist_index(n)];
+            obj* result = b.head;
+            if (result == nullptr){
+                int nobjs = __BATCH;
+                result = depot::allocate_batch(depot::round_up(n), nobjs);
+                b.count = nobjs;
+            }
+            b.head = result->free_list_link;
+            --b.count;
+            return result;
+        }
+
+        static void deallocate(void* p, size_t n){
+            if (p == nullptr) return;
+            if (n > static_cast<size_t>(depot::__MAX_BYTES)){
+                ::operator delete(p);
+                return;
+            }
+            __pool_thread_cache* cache = local();
+            if (cache == nullptr){
+                depot::deallocate(p, n);
+                return;
+            }
+            bin& b = cache->bins[depot::freelist_index(n)];
+            obj* q = static_cast<obj*>(p);
+            q->free_list_link = b.head;
+            b.head = q;
+            if (++b.count > __HIGH_WATER){
+                // 把链表头部的一批归还 depot，保留其余部分
+                obj* last = b.head;
+                for (int i = 1; i < __BATCH; ++i) last = last->free_list_link;
+                obj* first = b.head;
+                b.head = last->free_list_link;
+                b.count -= __BATCH;
+                depot::deallocate_batch(first, last, depot::round_up(n));
+            }
+        }
+    };
+
+    typedef __pool_alloc_template<0> pool_alloc;
+    typedef __pool_thread_cache<0>   pool_thread_cache;
+
+    // ---------------------------------------------------------------------------------------
+    // pool_allocator
+    // 接口与 allocator 相同，可作为 list、__hashtable 以及 deque map 的 Alloc
+    // 经由当前线程的 pool_thread_cache 分配，归还到调用 deallocate 的线程的缓存中
+    // 归还空间时必须给出与申请时相同的个数 n，deallocate(p) 视为归还一个对象
+    // 内存池只保证 __ALIGN 对齐，alignof(T) 更大的类型直接按 alignof(T) 向系统申请
+
+    template <class T>
+    class pool_allocator{
+    private:
+        enum { __OVER_ALIGNED = alignof(T) > pool_alloc::alignment() };
+        typedef __aligned_storage<alignof(T)> __aligned;
+
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        template <class U>
+        struct rebind{
+            typedef pool_allocator<U> other;
+        };
+
+        pool_allocator() noexcept = default;
+        template <class U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return size_type(UINT_MAX / sizeof(T)); }
+
+        pointer allocate(size_type n){
+            if (n == 0) return nullptr;
+            if (__OVER_ALIGNED) return static_cast<pointer>(__aligned::allocate(n * sizeof(T)));
+            return static_cast<pointer>(pool_thread_cache::allocate(n * sizeof(T)));
+        }
+        // 小型区块按 size class 上调，上调出来的部分同样可用；归还时传入 count 与传入 n 落在同一个 size class
+        allocation_result<pointer> allocate_at_least(size_type n){
+            pointer p = allocate(n);
+            if (n == 0 || __OVER_ALIGNED) return { p, n };
+            return { p, pool_alloc::good_size(n * sizeof(T)) / sizeof(T) };
+        }
+        void deallocate(pointer p, size_type n){
+            if (n == 0 || p == nullptr) return;
+            if (__OVER_ALIGNED) __aligned::deallocate(p);
+            else                pool_thread_cache::deallocate(p, n * sizeof(T));
+        }
+        void deallocate(pointer p) { deallocate(p, 1); }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept { return true; }
+
+    template <class T, class U>
+    bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept { return false; }
+
 }
 
-#endif
\ No newline at end of file
+#endif
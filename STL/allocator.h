@@ -4,6 +4,8 @@
 // #include <new>
 #include <cstddef>
 #include <climits>
+#include <type_traits>
+#include <utility>
 #include "construct.h"
 
 namespace pocket_stl{
@@ -18,11 +20,11 @@ namespace pocket_stl{
         typedef T&              reference;
         typedef const T&        const_reference;
 
-        // default ctor
-        // copy ctor
-        // dtor
-
     public:
+        allocator() noexcept {}
+        template <class U>
+        allocator(const allocator<U>&) noexcept {}
+
         // rebind 允许一个类型对象的 allocator 分配其他类型的存储
         template <class U>
         struct rebind{
@@ -45,6 +47,59 @@ namespace pocket_stl{
         void            destroy(pointer p);                             // 对象析构操作
     };
 
+    // allocate_at_least 的返回值，ptr 指向的空间可以容纳 count 个对象，count 不小于请求的个数
+    template <class Pointer>
+    struct allocation_result{
+        Pointer ptr;
+        size_t  count;
+    };
+
+    // 分配至少 n 个对象的空间，并告知实际可用的个数，容器据此把分配器上调的部分计入 capacity
+    // Alloc 提供成员 allocate_at_least 时调用它，否则退回 allocate(n)，count 即为 n
+    template <class Alloc>
+    auto __allocate_at_least(Alloc& a, size_t n, int) -> decltype(a.allocate_at_least(n)){
+        return a.allocate_at_least(n);
+    }
+
+    template <class Alloc>
+    auto __allocate_at_least(Alloc& a, size_t n, long) -> allocation_result<decltype(a.allocate(n))>{
+        return { a.allocate(n), n };
+    }
+
+    template <class Alloc>
+    auto allocate_at_least(Alloc& a, size_t n) -> decltype(__allocate_at_least(a, n, 0)){
+        return __allocate_at_least(a, n, 0);
+    }
+
+    // 把 [p, p + n) 扩展为至少容纳 new_n 个对象的空间，成功时返回新的位置与实际个数，失败返回 { nullptr, 0 }，原空间不变
+    // may_move 为 false 时只允许原地扩展；为 true 时允许分配器把内容按位搬到新地址，要求元素 trivially relocatable
+    // Alloc 没有提供成员 reallocate_at_least 时总是失败
+    template <class Alloc, class Pointer>
+    auto __reallocate_at_least(Alloc& a, Pointer p, size_t n, size_t new_n, bool may_move, int)
+        -> decltype(a.reallocate_at_least(p, n, new_n, may_move)){
+        return a.reallocate_at_least(p, n, new_n, may_move);
+    }
+
+    template <class Alloc, class Pointer>
+    allocation_result<Pointer> __reallocate_at_least(Alloc&, Pointer, size_t, size_t, bool, long){
+        return { Pointer(), 0 };
+    }
+
+    template <class Alloc, class Pointer>
+    allocation_result<Pointer> reallocate_at_least(Alloc& a, Pointer p, size_t n, size_t new_n, bool may_move){
+        return __reallocate_at_least(a, p, n, new_n, may_move, 0);
+    }
+
+    template <class Alloc>
+    auto __has_reallocate_at_least_test(int) -> decltype(std::declval<Alloc&>().reallocate_at_least(
+            std::declval<typename Alloc::pointer>(), size_t(), size_t(), bool()), std::true_type());
+
+    template <class Alloc>
+    std::false_type __has_reallocate_at_least_test(long);
+
+    template <class Alloc>
+    struct __has_reallocate_at_least : decltype(__has_reallocate_at_least_test<Alloc>(0)) {};
+
     // 用以压缩 allocator 实例化所占用的空间
     template <class T, class Alloc>
     class compressed_pair : public Alloc{
@@ -54,6 +109,10 @@ namespace pocket_stl{
         T data;
         compressed_pair() = default;
         compressed_pair(T x) : data(x){}
+        compressed_pair(T x, const Alloc& a) : Alloc(a), data(x){}
+
+        Alloc&          get_allocator() noexcept { return *this; }
+        const Alloc&    get_allocator() const noexcept { return *this; }
         operator T() { return data; }
     };
 
@@ -111,6 +170,13 @@ namespace pocket_stl{
         // pocket_stl::destroy(p, pocket_stl::__true_type());
         return;
     }
+
+    // allocator 没有状态，任意两个实例都可以释放对方分配的空间
+    template <class T, class U>
+    bool operator==(const allocator<T>&, const allocator<U>&) noexcept { return true; }
+
+    template <class T, class U>
+    bool operator!=(const allocator<T>&, const allocator<U>&) noexcept { return false; }
 }
 
 #endif
\ No newline at end of file
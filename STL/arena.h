@@ -0,0 +1,217 @@
+#ifndef _POCKET_ARENA_H_
+#define _POCKET_ARENA_H_
+
+/*
+** monotonic arena
+** 只增不减的 bump-pointer 分配器，deallocate 不做任何事，
+** 内存在 arena_scope 结束或 release() 时以 O(1) 的代价整体回收，
+** 适合生命周期与一次请求相同的一批临时容器
+*/
+
+#include <cstddef>
+#include <climits>
+#include <new>
+#include "construct.h"
+
+namespace pocket_stl{
+
+    class monotonic_arena{
+    private:
+        // 每块 chunk 的头部，chunk 按申请顺序串成单链表，回收时只回退指针而不释放 chunk
+        struct chunk_header{
+            chunk_header*   next;
+            size_t          size;       // 可用于分配的字节数，不含头部
+        };
+
+        enum { __DEFAULT_CHUNK_SIZE = 4096 };
+        enum { __MAX_ALIGN = alignof(std::max_align_t) };
+
+        chunk_header*   head_;          // 第一块 chunk
+        chunk_header*   current_;       // 正在使用的 chunk
+        char*           cur_;           // 下一次分配的起点
+        char*           end_;           // 当前 chunk 的结束位置
+        size_t          next_chunk_size_;
+
+    public:
+        // 记录某一时刻的分配位置，rewind 时回到该位置
+        struct marker{
+            chunk_header*   chunk;
+            char*           cur;
+        };
+
+    public:
+        explicit monotonic_arena(size_t initial_size = __DEFAULT_CHUNK_SIZE) noexcept
+            : head_(nullptr), current_(nullptr), cur_(nullptr), end_(nullptr),
+              next_chunk_size_(initial_size == 0 ? size_t(__DEFAULT_CHUNK_SIZE) : initial_size) {}
+
+        ~monotonic_arena(){
+            while (head_ != nullptr){
+                chunk_header* next = head_->next;
+                ::operator delete(head_);
+                head_ = next;
+            }
+        }
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+    public:
+        void* allocate(size_t bytes, size_t align = __MAX_ALIGN){
+            char* p = align_up(cur_, align);
+            if (cur_ == nullptr || p + bytes > end_){
+                next_chunk(bytes + align);
+                p = align_up(cur_, align);
+            }
+            cur_ = p + bytes;
+            return p;
+        }
+
+        void deallocate(void*, size_t) noexcept {}
+
+        marker mark() const noexcept { return marker{ current_, cur_ }; }
+
+        // 回到 m 记录的位置，之后分配出的空间全部作废，chunk 保留以便复用
+        void rewind(const marker& m) noexcept{
+            if (m.chunk == nullptr){
+                release();
+                return;
+            }
+            current_ = m.chunk;
+            cur_ = m.cur;
+            end_ = data(current_) + current_->size;
+        }
+
+        // 作废全部已分配空间，chunk 保留以便复用
+        void release() noexcept{
+            current_ = head_;
+            cur_ = head_ ? data(head_) : nullptr;
+            end_ = head_ ? data(head_) + head_->size : nullptr;
+        }
+
+    private:
+        static char* data(chunk_header* c) noexcept{
+            return reinterpret_cast<char*>(c) + header_size();
+        }
+        static constexpr size_t header_size() noexcept{
+            return (sizeof(chunk_header) + __MAX_ALIGN - 1) & ~(static_cast<size_t>(__MAX_ALIGN) - 1);
+        }
+        static char* align_up(char* p, size_t align) noexcept{
+            const size_t addr = reinterpret_cast<size_t>(p);
+            return reinterpret_cast<char*>((addr + align - 1) & ~(align - 1));
+        }
+
+        // 切换到下一块至少能容纳 need 字节的 chunk，优先复用 rewind 之后留下的 chunk
+        void next_chunk(size_t need){
+            chunk_header* next = current_ ? current_->next : head_;
+            if (next == nullptr || next->size < need){
+                size_t size = next_chunk_size_;
+                while (size < need) size *= 2;
+                chunk_header* c = static_cast<chunk_header*>(::operator new(header_size() + size));
+                c->size = size;
+                c->next = next;
+                if (current_) current_->next = c;
+                else head_ = c;
+                next = c;
+                next_chunk_size_ = size * 2;
+            }
+            current_ = next;
+            cur_ = data(current_);
+            end_ = cur_ + current_->size;
+        }
+    };
+
+    // 当前线程正在生效的 arena，由 arena_scope 设置
+    inline monotonic_arena*& __current_arena() noexcept{
+        static thread_local monotonic_arena* arena = nullptr;
+        return arena;
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // arena_scope
+    // 构造时记录 arena 的位置并设为当前线程的 arena，析构时恢复并以 O(1) 回收期间的全部分配
+    // 在 scope 内创建的容器不能在 scope 结束后继续使用
+
+    class arena_scope{
+    private:
+        monotonic_arena&        arena_;
+        monotonic_arena::marker mark_;
+        monotonic_arena*        prev_;
+
+    public:
+        explicit arena_scope(monotonic_arena& arena) noexcept
+            : arena_(arena), mark_(arena.mark()), prev_(__current_arena()){
+            __current_arena() = &arena_;
+        }
+        ~arena_scope(){
+            __current_arena() = prev_;
+            arena_.rewind(mark_);
+        }
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+    };
+
+    // ---------------------------------------------------------------------------------------
+    // arena_allocator
+    // 可作为 vector、basic_string、__hashtable 等容器的 Alloc
+    // 默认构造时绑定当前线程的 arena（见 arena_scope），没有生效的 arena 时退回 ::operator new
+
+    template <class T>
+    class arena_allocator{
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        template <class U>
+        struct rebind{
+            typedef arena_allocator<U> other;
+        };
+
+    private:
+        template <class> friend class arena_allocator;
+        monotonic_arena* arena_;
+
+    public:
+        arena_allocator() noexcept : arena_(__current_arena()) {}
+        explicit arena_allocator(monotonic_arena& arena) noexcept : arena_(&arena) {}
+        template <class U>
+        arena_allocator(const arena_allocator<U>& rhs) noexcept : arena_(rhs.arena_) {}
+
+        monotonic_arena* arena() const noexcept { return arena_; }
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return size_type(UINT_MAX / sizeof(T)); }
+
+        pointer allocate(size_type n){
+            if (arena_ == nullptr){
+                return static_cast<pointer>(::operator new(n * sizeof(T)));
+            }
+            return static_cast<pointer>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+        void deallocate(pointer p, size_type){
+            if (arena_ == nullptr) ::operator delete(p);
+        }
+        void deallocate(pointer p) { deallocate(p, 1); }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+
+        template <class U>
+        bool operator==(const arena_allocator<U>& rhs) const noexcept { return arena_ == rhs.arena_; }
+        template <class U>
+        bool operator!=(const arena_allocator<U>& rhs) const noexcept { return arena_ != rhs.arena_; }
+    };
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 */
 
 #include <assert.h>
+#include <cstring>
 #include <cwchar>
 
 #include "iterator.h"
@@ -39,26 +40,13 @@ namespace pocket_stl{
 
         static char_type* copy(char_type* dst, const char_type* src, size_t n) {
             assert(src + n <= dst || dst + n <= src);
-            char_type* r = dst;
-            for (; n != 0; --n, ++dst, ++src)
-                *dst = *src;
-            return r;
+            // charT 必须是 POD，整段 memcpy 即可
+            return static_cast<char_type*>(std::memcpy(dst, src, n * sizeof(char_type)));
         }
 
         // 考虑发生重叠的情况
         static char_type* move(char_type* dst, const char_type* src, size_t n){
-            char_type* r = dst;
-            if (dst < src){
-                for (; n != 0; --n, ++dst, ++src)
-                    *dst = *src;
-            }
-            else if (src < dst){
-                dst += n;
-                src += n;
-                for (; n != 0; --n)
-                    *--dst = *--src;
-            }
-            return r;
+            return static_cast<char_type*>(std::memmove(dst, src, n * sizeof(char_type)));
         }
 
         static char_type* fill(char_type* dst, char_type ch, size_t count){
@@ -150,25 +138,11 @@ namespace pocket_stl{
 
         static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept{
             assert(src + n <= dst || dst + n <= src);
-            char_type* r = dst;
-            for (; n != 0; --n, ++dst, ++src)
-                *dst = *src;
-            return r;
+            return static_cast<char_type*>(std::memcpy(dst, src, n * sizeof(char_type)));
         }
 
         static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept{
-            char_type* r = dst;
-            if (dst < src){
-                for (; n != 0; --n, ++dst, ++src)
-                    *dst = *src;
-            }
-            else if (src < dst){
-                dst += n;
-                src += n;
-                for (; n != 0; --n)
-                    *--dst = *--src;
-            }
-            return r;
+            return static_cast<char_type*>(std::memmove(dst, src, n * sizeof(char_type)));
         }
 
         static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept{
@@ -203,26 +177,12 @@ namespace pocket_stl{
 
         static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept{
             assert(src + n <= dst || dst + n <= src);
-            char_type* r = dst;
-            for (; n != 0; --n, ++dst, ++src)
-                *dst = *src;
-            return r;
+            return static_cast<char_type*>(std::memcpy(dst, src, n * sizeof(char_type)));
         }
 
         static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
         {
-            char_type* r = dst;
-            if (dst < src){
-                for (; n != 0; --n, ++dst, ++src)
-                    *dst = *src;
-            }
-            else if (src < dst){
-                dst += n;
-                src += n;
-                for (; n != 0; --n)
-                    *--dst = *--src;
-            }
-            return r;
+            return static_cast<char_type*>(std::memmove(dst, src, n * sizeof(char_type)));
         }
 
         static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept{
@@ -260,7 +220,7 @@ namespace pocket_stl{
         using reverse_iterator          = std::reverse_iterator<iterator>;
         using const_reverse_iterator    = std::reverse_iterator<const_iterator>;
 
-        allocator_type get_allocator() { return allocator_type(); }
+        allocator_type get_allocator() const noexcept { return data_allocator().get_allocator(); }
         
         static_assert(std::is_pod<charT>::value, "Character type of basic_string must be a POD");
         static_assert(std::is_same<charT, typename traits_type::char_type>::value,
@@ -284,53 +244,60 @@ namespace pocket_stl{
         basic_string() noexcept
         { try_init(); }
 
-        basic_string(size_type n, value_type ch)
-                :buffer_(nullptr), size_(0){
-            cap_() = 0;
+        explicit basic_string(const allocator_type& alloc) noexcept
+                :cap_and_alloc_(0, alloc)
+        { try_init(); }
+
+        basic_string(size_type n, value_type ch, const allocator_type& alloc = allocator_type())
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, alloc){
             fill_init(n, ch);
         }
 
-        basic_string(const basic_string& other, size_type pos)
-                :buffer_(nullptr), size_(0)
+        basic_string(const basic_string& other, size_type pos, const allocator_type& alloc = allocator_type())
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, alloc)
         {
-            cap_() = 0;
             init_from(other.buffer_, pos, other.size_ - pos);
         }
 
-        basic_string(const basic_string& other, size_type pos, size_type count)
-                :buffer_(nullptr), size_(0){
-            cap_() = 0;
+        basic_string(const basic_string& other, size_type pos, size_type count,
+                     const allocator_type& alloc = allocator_type())
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, alloc){
             init_from(other.buffer_, pos, count);
         }
 
-        basic_string(const_pointer str)
-                :buffer_(nullptr), size_(0){
-            cap_() = 0;
+        basic_string(const_pointer str, const allocator_type& alloc = allocator_type())
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, alloc){
             init_from(str, 0, char_traits::length(str));
         }
 
-        basic_string(const_pointer str, size_type count)
-                :buffer_(nullptr), size_(0){
-            cap_() = 0;
+        basic_string(const_pointer str, size_type count, const allocator_type& alloc = allocator_type())
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, alloc){
             init_from(str, 0, count);
         }
 
         template <class Iter, class = typename std::enable_if<!std::is_integral<Iter>::value>::type>
-        basic_string(Iter first, Iter last)
+        basic_string(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+                :cap_and_alloc_(0, alloc)
         { copy_init(first, last, iterator_category(first)); }
 
+        // 复制 rhs 的 allocator
         basic_string(const basic_string& rhs) 
-                :buffer_(nullptr), size_(0){
-            cap_() = 0;
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, rhs.data_allocator().get_allocator()){
             init_from(rhs.buffer_, 0, rhs.size_);
         }
 
+        basic_string(const basic_string& rhs, const allocator_type& alloc)
+                :buffer_(nullptr), size_(0), cap_and_alloc_(0, alloc){
+            init_from(rhs.buffer_, 0, rhs.size_);
+        }
+
+        // allocator 随 buffer 一起转移
         basic_string(basic_string&& rhs) noexcept
-                :buffer_(rhs.buffer_), size_(rhs.size_){
-            cap_() = rhs.cap_();
+                :buffer_(rhs.buffer_), size_(rhs.size_),
+                 cap_and_alloc_(rhs.cap_(), rhs.data_allocator().get_allocator()){
             rhs.buffer_ = nullptr;
             rhs.size_ = 0;
-            rhs.cap_ = 0;
+            rhs.cap_() = 0;
         }
 
         basic_string& operator=(const basic_string& rhs);
@@ -379,7 +346,7 @@ namespace pocket_stl{
         size_type length()   const noexcept
         { return size_; }
         size_type capacity() const noexcept
-        { return cap_; }
+        { return cap_(); }
         size_type max_size() const noexcept
         { return static_cast<size_type>(-1); }
 
@@ -475,6 +442,11 @@ namespace pocket_stl{
         // resize
         void    resize(size_type count) { resize(count, value_type()); }
         void    resize(size_type count, value_type ch);
+        // 新增的字符不做初始化，留给调用者直接覆盖
+        void    resize_default_init(size_type count);
+        // count 大于 size() 时先 resize_default_init(count)，再由 op(buffer, count) 写入内容并返回实际的长度 r（r <= count）
+        template <class Operation>
+        void    resize_and_overwrite(size_type count, Operation op);
 
         void     clear() noexcept { size_ = 0; }
 
@@ -670,7 +642,7 @@ namespace pocket_stl{
     basic_string<charT, traits, Alloc>::
     operator=(const basic_string& rhs){
         if (this != &rhs){
-            basic_string tmp(rhs);
+            basic_string tmp(rhs, get_allocator());
             swap(tmp);
         }
         return *this;
@@ -685,10 +657,11 @@ namespace pocket_stl{
         destroy_buffer();
         buffer_ = rhs.buffer_;
         size_ = rhs.size_;
-        cap_() = rhs.cap_;
+        cap_() = rhs.cap_();
+        data_allocator().get_allocator() = rhs.data_allocator().get_allocator();
         rhs.buffer_ = nullptr;
         rhs.size_ = 0;
-        rhs.cap_ = 0;
+        rhs.cap_() = 0;
         return *this;
     }
 
@@ -699,9 +672,9 @@ namespace pocket_stl{
     operator=(const_pointer str)
     {
         const size_type len = char_traits::length(str);
-        if (cap_() < len){
+        if (cap_() <= len){
             auto new_buffer = data_allocator().allocate(len + 1);
-            data_allocator().deallocate(buffer_);
+            data_allocator().deallocate(buffer_, cap_());
             buffer_ = new_buffer;
             cap_() = len + 1;
         }
@@ -716,9 +689,9 @@ namespace pocket_stl{
     basic_string<charT, traits, Alloc>::
     operator=(value_type ch)
     {
-        if (cap_() < 1){
+        if (cap_() < 2){
             auto new_buffer = data_allocator().allocate(2);
-            data_allocator().deallocate(buffer_);
+            data_allocator().deallocate(buffer_, cap_());
             buffer_ = new_buffer;
             cap_() = 2;
         }
@@ -734,10 +707,11 @@ namespace pocket_stl{
         if (cap_() < n){
             THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size()"
                                 "in basic_string<Char,Traits>::reserve(n)");
-            auto new_buffer = data_allocator().allocate(n);
-            char_traits::move(new_buffer, buffer_, size_);
-            buffer_ = new_buffer;
-            cap_() = n;
+            auto r = pocket_stl::allocate_at_least(data_allocator(), n);
+            char_traits::move(r.ptr, buffer_, size_);
+            data_allocator().deallocate(buffer_, cap_());
+            buffer_ = r.ptr;
+            cap_() = r.count;
         }
     }
 
@@ -903,6 +877,41 @@ namespace pocket_stl{
         }
     }
 
+    // 改变容器大小，新增部分不初始化；多留一个位置给 c_str() 的结尾符
+    template <class charT, class traits, class Alloc>
+    void basic_string<charT, traits, Alloc>::
+    resize_default_init(size_type count){
+        if (count > size_){
+            THROW_LENGTH_ERROR_IF(count >= max_size(), "basic_string<Char, Tratis>'s size too big");
+            if (cap_() <= count){
+                reallocate(count + 1 - size_);
+            }
+        }
+        size_ = count;
+    }
+
+    // 由 op 直接写入缓冲区，op 返回之后才截断；op 抛出异常时恢复原来的长度，
+    // 下标不小于 count 的原有字符不变，[0, count) 中的字符可能已被 op 改写
+    template <class charT, class traits, class Alloc>
+    template <class Operation>
+    void basic_string<charT, traits, Alloc>::
+    resize_and_overwrite(size_type count, Operation op){
+        const size_type old_size = size_;
+        if (count > old_size) resize_default_init(count);
+        size_type r;
+        try{
+            r = static_cast<size_type>(op(buffer_, count));
+        }
+        catch(...){
+            size_ = old_size;
+            throw;
+        }
+        if (r > count) size_ = old_size;
+        THROW_LENGTH_ERROR_IF(r > count, "basic_string<Char, Traits>::resize_and_overwrite() "
+                              "returned a size larger than count");
+        size_ = r;
+    }
+
     // 比较两个 basic_string，小于返回 -1，大于返回 1，等于返回 0
     template <class charT, class traits, class Alloc>
     int basic_string<charT, traits, Alloc>::
@@ -970,7 +979,8 @@ namespace pocket_stl{
         if (this != &rhs){
             std::swap(buffer_, rhs.buffer_);
             std::swap(size_, rhs.size_);
-            std::swap(cap_(), rhs.cap_);
+            std::swap(cap_(), rhs.cap_());
+            std::swap(data_allocator().get_allocator(), rhs.data_allocator().get_allocator());
         }
     }
 
@@ -1410,7 +1420,7 @@ namespace pocket_stl{
         try{
             buffer_ = data_allocator().allocate(static_cast<size_type>(STRING_INIT_SIZE));
             size_ = 0;
-            cap_() = 0;
+            cap_() = static_cast<size_type>(STRING_INIT_SIZE);
         }
         catch (...){
             buffer_ = nullptr;
@@ -1516,8 +1526,10 @@ namespace pocket_stl{
             char_traits::move(new_buffer, buffer_, size);
         }
         catch (...){
-            data_allocator().deallocate(new_buffer);
+            data_allocator().deallocate(new_buffer, size);
+            throw;
         }
+        data_allocator().deallocate(buffer_, cap_());
         buffer_ = new_buffer;
         size_ = size;
         cap_() = size;
@@ -1645,11 +1657,11 @@ namespace pocket_stl{
     void basic_string<charT, traits, Alloc>::
     reallocate(size_type need){
         const auto new_cap = std::max(cap_() + need, cap_() + (cap_() >> 1));
-        auto new_buffer = data_allocator().allocate(new_cap);
-        char_traits::move(new_buffer, buffer_, size_);
-        data_allocator().deallocate(buffer_);
-        buffer_ = new_buffer;
-        cap_() = new_cap;
+        auto nb = pocket_stl::allocate_at_least(data_allocator(), new_cap);
+        char_traits::move(nb.ptr, buffer_, size_);
+        data_allocator().deallocate(buffer_, cap_());
+        buffer_ = nb.ptr;
+        cap_() = nb.count;
     }
 
     // reallocate_and_fill 函数
@@ -1660,14 +1672,14 @@ namespace pocket_stl{
         const auto r = pos - buffer_;
         const auto old_cap = cap_();
         const auto new_cap = std::max(old_cap + n, old_cap + (old_cap >> 1));
-        auto new_buffer = data_allocator().allocate(new_cap);
-        auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
+        auto nb = pocket_stl::allocate_at_least(data_allocator(), new_cap);
+        auto e1 = char_traits::move(nb.ptr, buffer_, r) + r;
         auto e2 = char_traits::fill(e1, ch, n) + n;
         char_traits::move(e2, buffer_ + r, size_ - r);
         data_allocator().deallocate(buffer_, old_cap);
-        buffer_ = new_buffer;
+        buffer_ = nb.ptr;
         size_ += n;
-        cap_() = new_cap;
+        cap_() = nb.count;
         return buffer_ + r;
     }
 
@@ -1680,14 +1692,14 @@ namespace pocket_stl{
         const auto old_cap = cap_();
         const size_type n = std::distance(first, last);
         const auto new_cap = std::max(old_cap + n, old_cap + (old_cap >> 1));
-        auto new_buffer = data_allocator().allocate(new_cap);
-        auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
-        auto e2 = pocket_stl::uninitialized_copy_n(first, n, e1) + n;
+        auto nb = pocket_stl::allocate_at_least(data_allocator(), new_cap);
+        auto e1 = char_traits::move(nb.ptr, buffer_, r) + r;
+        auto e2 = pocket_stl::uninitialized_copy_n(first, n, e1);
         char_traits::move(e2, buffer_ + r, size_ - r);
         data_allocator().deallocate(buffer_, old_cap);
-        buffer_ = new_buffer;
+        buffer_ = nb.ptr;
         size_ += n;
-        cap_() = new_cap;
+        cap_() = nb.count;
         return buffer_ + r;
     }
 
@@ -1839,9 +1851,13 @@ namespace pocket_stl{
         lhs.swap(rhs);
     }
 
+    // basic_string 没有 SSO，只持有指向堆空间的指针，可以按位搬移
+    template <class charT, class traits, class Alloc>
+    struct is_trivially_relocatable<basic_string<charT, traits, Alloc>> : is_trivially_relocatable<Alloc> {};
+
     // 特化 mystl::hash
     template <class charT, class traits, class Alloc>
-    struct pocket_stl::hash<basic_string<charT, traits, Alloc>>{
+    struct hash<basic_string<charT, traits, Alloc>>{
         size_t operator()(const basic_string<charT, traits, Alloc>& str)
         {
             return bitwise_hash((const unsigned char*)str.c_str(),
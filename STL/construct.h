@@ -7,6 +7,7 @@
 */
 
 #include <new>
+#include <utility>
 #include "iterator.h"
 #include "type_traits.h"
 
@@ -29,11 +30,16 @@ namespace pocket_stl{
 
     template <class T>
     void destroy(T* p, __false_type){
-        if (!p) {
+        if (p) {
             p->~T();
         }
     }
 
+    template <class T>
+    void destroy(T* p){
+        destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+    }
+
     template <class ForwardIterator>
     void __destroy(ForwardIterator first, ForwardIterator last, __true_type) { }
 
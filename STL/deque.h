@@ -14,7 +14,9 @@
 
 namespace pocket_stl{
     #define DEQUE_INIT_MAP_SIZE 8
-    
+
+    struct __deque_segments;
+
     template <class T, class Ref, class Ptr>
     class __deque_iterator{
     public:
@@ -32,6 +34,8 @@ namespace pocket_stl{
     private:
         template <class, class> friend class deque;
         template <class, class, class >friend class __deque_iterator;
+        friend struct __deque_segments;
+        template <class> friend struct __segmented_iterator_traits;
         T* cur;
         T* first;
         T* last;
@@ -133,8 +137,8 @@ namespace pocket_stl{
         bool operator!=(const self& x) const { return cur != x.cur; }
         bool operator<(const self& x) const { return (node == x.node) ? (cur < x.cur) : (node < x.node); }
         bool operator>(const self& x) const { return (node == x.node) ? (cur > x.cur) : (node > x.node); }
-        bool operator<=(const self& x) const { return !operator<(x); }
-        bool operator>=(const self& x) const { return !operator>(x); }
+        bool operator<=(const self& x) const { return !x.operator<(*this); }
+        bool operator>=(const self& x) const { return !operator<(x); }
 
     private:
         void set_node(map_pointer new_node){
@@ -144,6 +148,25 @@ namespace pocket_stl{
         }
     };
 
+    // 每一段是 map 中一个节点指向的缓冲区
+    template <class T, class Ref, class Ptr>
+    struct __segmented_iterator_traits<__deque_iterator<T, Ref, Ptr>>{
+        typedef std::true_type                  is_segmented;
+        typedef __deque_iterator<T, Ref, Ptr>   iterator;
+        typedef T**                             segment_iterator;
+        typedef Ptr                             local_iterator;
+
+        static segment_iterator segment(const iterator& it) { return it.node; }
+        static local_iterator   local(const iterator& it) { return it.cur; }
+        static local_iterator   begin(segment_iterator seg) { return *seg; }
+        static local_iterator   end(segment_iterator seg) { return *seg + iterator::buffer_size(); }
+        // 落在块尾时归到下一块的开头，与 deque 迭代器 cur 不等于 last 的约定一致
+        static iterator         compose(segment_iterator seg, local_iterator local){
+            if (local == end(seg)) return iterator(*(seg + 1), seg + 1);
+            return iterator(const_cast<T*>(local), seg);
+        }
+    };
+
     template <class T, class Alloc = pocket_stl::allocator<T>>
     class deque{
     public:
@@ -183,19 +206,38 @@ namespace pocket_stl{
     public:
         /***************ctor 、 copy_ctor 、 move_ctor 、 dtor 、 operator=*****************/
         explicit deque() { allocate_and_fill(0, value_type()); }
-        explicit deque(size_type n) { allocate_and_fill(n, value_type()); }
-        deque(size_type n, const value_type& val) { allocate_and_fill(n, val); }
+        explicit deque(const allocator_type& alloc)
+            : __start_and_data_alloc(iterator(), alloc), __finish_and_map_alloc(iterator(), alloc)
+        { allocate_and_fill(0, value_type()); }
+        explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+            : __start_and_data_alloc(iterator(), alloc), __finish_and_map_alloc(iterator(), alloc)
+        { allocate_and_fill(n, value_type()); }
+        deque(size_type n, const value_type& val, const allocator_type& alloc = allocator_type())
+            : __start_and_data_alloc(iterator(), alloc), __finish_and_map_alloc(iterator(), alloc)
+        { allocate_and_fill(n, val); }
         template <class InputIterator, class = typename std::enable_if<
                                            !std::is_integral<InputIterator>::value>::type>
-        deque(InputIterator first, InputIterator last) { allocate_and_copy(first, last); } 
-        deque(const deque& x) { allocate_and_copy(x.begin(), x.end()); }
-        deque(deque&& x) : __map(std::move(x.__map)), __map_size(std::move(x.__map_size)){
-            __start() = std::move(x.__start());
-            __finish() = std::move(x.__finish());
+        deque(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+            : __start_and_data_alloc(iterator(), alloc), __finish_and_map_alloc(iterator(), alloc)
+        { allocate_and_copy(first, last); } 
+        // 复制 x 的 allocator
+        deque(const deque& x)
+            : __start_and_data_alloc(iterator(), x.__data_allocator().get_allocator()),
+              __finish_and_map_alloc(iterator(), x.__map_allocator().get_allocator())
+        { allocate_and_copy(x.begin(), x.end()); }
+        // allocator 随 map 一起转移
+        deque(deque&& x)
+            : __start_and_data_alloc(x.__start(), x.__data_allocator().get_allocator()),
+              __finish_and_map_alloc(x.__finish(), x.__map_allocator().get_allocator()),
+              __map(x.__map), __map_size(x.__map_size){
+            x.__start() = iterator();
+            x.__finish() = iterator();
             x.__map = nullptr;
             x.__map_size = 0;
         }
-        deque(std::initializer_list<value_type> il) { allocate_and_copy(il.begin(), il.end()); }
+        deque(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+            : __start_and_data_alloc(iterator(), alloc), __finish_and_map_alloc(iterator(), alloc)
+        { allocate_and_copy(il.begin(), il.end()); }
         ~deque() { destroy_and_deallocate_all(); }
         deque& operator= (const deque& x);
         deque& operator= (deque&& x);
@@ -260,7 +302,7 @@ namespace pocket_stl{
         void        emplace_front (Args&&... args);
         template <class... Args>
         void        emplace_back (Args&&... args);
-        allocator_type get_allocator() const noexcept { return allocator_type(); }
+        allocator_type get_allocator() const noexcept { return __data_allocator().get_allocator(); }
 
        private:
         /***********************辅助工具*****************************/
@@ -273,6 +315,8 @@ namespace pocket_stl{
         void                destroy_and_deallocate_all();
         void                expand_at_back(size_type nodes_to_add = 1);
         void                expand_at_front(size_type nodes_to_add = 1);
+        void                reserve_elements_at_back(size_type n);
+        void                reserve_elements_at_front(size_type n);
         void                reserve_map_at_back(size_type nodes_to_add = 1);
         void                reserve_map_at_front(size_type nodes_to_add = 1);
         void                reallocate_map(size_type nodes_to_add, bool add_at_front);
@@ -283,6 +327,9 @@ namespace pocket_stl{
         void                insert_copy(iterator pos, InputIterator first, InputIterator last, size_type n);
         void                destroy_buffer(map_pointer first, map_pointer last);
         void                destroy_buffer(map_pointer node);
+        // 按缓冲区分段 memmove，仅用于 trivially relocatable 的元素
+        static iterator     relocate_segments(iterator first, iterator last, iterator result);
+        static iterator     relocate_segments_backward(iterator first, iterator last, iterator result);
     };
 
     /*-------------------------------部分函数定义------------------------------------*/
@@ -412,6 +459,8 @@ namespace pocket_stl{
         std::swap(__finish(), x.__finish());
         std::swap(__map, x.__map);
         std::swap(__map_size, x.__map_size);
+        std::swap(__data_allocator().get_allocator(), x.__data_allocator().get_allocator());
+        std::swap(__map_allocator().get_allocator(), x.__map_allocator().get_allocator());
     }
 
     template <class T, class Alloc>
@@ -464,12 +513,12 @@ namespace pocket_stl{
     void
     deque<T, Alloc>::pop_front(){
         if(__start().cur != __start().last - 1){
-            ++__start().cur;
             __data_allocator().destroy(__start().cur);
+            ++__start().cur;
         }
         else{
-            ++__start();
             __data_allocator().destroy(__start().cur);
+            ++__start();
             destroy_buffer(__start().node - 1);
         }
     }
@@ -514,25 +563,24 @@ namespace pocket_stl{
     typename deque<T, Alloc>::iterator
     deque<T, Alloc>::insert(const_iterator position, size_type n, const value_type& val){
         if(position.cur == __start().cur){
-            size_type nodes_to_add = (n - (__start().cur - __start().first)) / buffer_size();
-            expand_at_front(nodes_to_add);
+            reserve_elements_at_front(n);
             iterator new_begin = __start() - n;
-            uninitialized_fill_n(new_begin, n, val);
+            pocket_stl::uninitialized_fill_n(new_begin, n, val);
             __start() = new_begin;
             return __start();
         }
         else if(position.cur == __finish().cur){
-            size_type nodes_to_add = (n - (__finish().last - __start().cur) + 1) / buffer_size();
-            expand_at_back(nodes_to_add);
+            reserve_elements_at_back(n);
             iterator new_end = __finish() + n;
             iterator old_end = __finish();
-            uninitialized_fill_n(__finish(), n, val);
+            pocket_stl::uninitialized_fill_n(__finish(), n, val);
             __finish() = new_end;
             return old_end;
         }
         else{
+            const difference_type index = position - __start();
             insert_fill(position, n, val);
-            return position;
+            return __start() + index;
         }
     }
 
@@ -542,25 +590,24 @@ namespace pocket_stl{
     deque<T, Alloc>::insert(const_iterator position, InputIterator first, InputIterator last){
         const size_type n = std::distance(first, last);
         if(position.cur == __start().cur){
-            size_type nodes_to_add = (n - (__start().cur - __start().first)) / buffer_size();
-            expand_at_front(nodes_to_add);
+            reserve_elements_at_front(n);
             iterator new_begin = __start() - n;
-            uninitialized_copy(first, last, new_begin);
+            pocket_stl::uninitialized_copy(first, last, new_begin);
             __start() = new_begin;
             return __start();
         }
         else if(position.cur == __finish().cur){
-            size_type nodes_to_add = (n - (__finish().last - __start().cur) + 1) / buffer_size();
-            expand_at_back(nodes_to_add);
+            reserve_elements_at_back(n);
             iterator new_end = __finish() + n;
             iterator old_end = __finish();
-            uninitialized_copy(first, last, __finish());
+            pocket_stl::uninitialized_copy(first, last, __finish());
             __finish() = new_end;
             return old_end;
         }
-        else{            
+        else{
+            const difference_type index = position - __start();
             insert_copy(position, first, last, n);
-            return position;
+            return __start() + index;
         }           
     }
 
@@ -570,13 +617,16 @@ namespace pocket_stl{
         iterator next = position;
         iterator pos = position;
         ++next;
+        if (is_trivially_relocatable<T>::value){
+            return erase(pos, next);
+        }
         difference_type index = pos - __start();
         if(index < difference_type(size() >> 1)){
-            pocket_stl::copy_backward(__start(), pos, next);
+            pocket_stl::move_backward(__start(), pos, next);
             pop_front();
         }
         else{
-            pocket_stl::copy(next, __finish(), pos);
+            pocket_stl::move(next, __finish(), pos);
             pop_back();
         }
         return __start() + index;
@@ -595,9 +645,15 @@ namespace pocket_stl{
             difference_type n = last - first;
             difference_type elems_before = first - __start();
             if(elems_before < difference_type(size() - n) / 2){
-                pocket_stl::copy_backward(__start(), f, l);
                 iterator new_start = __start() + n;
-                destroy(__start(), new_start);
+                if (is_trivially_relocatable<T>::value){
+                    destroy(f, l);
+                    relocate_segments_backward(__start(), f, l);
+                }
+                else{
+                    pocket_stl::move_backward(__start(), f, l);
+                    destroy(__start(), new_start);
+                }
                 for (map_pointer cur = __start().node; cur < new_start.node; ++cur){
                     __data_allocator().deallocate(*cur, buffer_size());
                     *cur = nullptr;
@@ -605,8 +661,15 @@ namespace pocket_stl{
                 __start() = new_start;
             }
             else{
-                pocket_stl::copy(l, __finish(), f);
                 iterator new_finish = __finish() - n;
+                if (is_trivially_relocatable<T>::value){
+                    destroy(f, l);
+                    relocate_segments(l, __finish(), f);
+                }
+                else{
+                    pocket_stl::move(l, __finish(), f);
+                    destroy(new_finish, __finish());
+                }
                 for (map_pointer cur = new_finish.node + 1; cur <= __finish().node; ++cur){
                     __data_allocator().deallocate(*cur, buffer_size());
                     *cur = nullptr;
@@ -656,9 +719,9 @@ namespace pocket_stl{
         map_pointer cur;
         
         for (cur = __start().node; cur < __finish().node; ++cur){
-            uninitialized_fill(*cur, *cur + buffer_size(), val);
+            pocket_stl::uninitialized_fill(*cur, *cur + buffer_size(), val);
         }
-        uninitialized_fill(__finish().first, __finish().cur, val);
+        pocket_stl::uninitialized_fill(__finish().first, __finish().cur, val);
         
     }
 
@@ -671,10 +734,10 @@ namespace pocket_stl{
         for (auto cur = __start().node; cur < __finish().node; ++cur){
             auto next = first;
             std::advance(next, buffer_size());
-            uninitialized_copy(first, next, *cur);
+            pocket_stl::uninitialized_copy(first, next, *cur);
             first = next;
         }
-        uninitialized_copy(first, last, __finish().first);
+        pocket_stl::uninitialized_copy(first, last, __finish().first);
     }
 
     template <class T, class Alloc>
@@ -712,7 +775,7 @@ namespace pocket_stl{
     void
     deque<T, Alloc>::destroy_and_deallocate_all(){
         for (auto cur = __start().node + 1; cur < __finish().node; ++cur){
-            destroy(*cur, *(cur + buffer_size()));
+            destroy(*cur, *cur + buffer_size());
         }
         if(__start().node != __finish().node){
             destroy(__start().cur, __start().last);
@@ -747,6 +810,25 @@ namespace pocket_stl{
         }
     }
 
+    // 保证 finish 之后至少有 n 个可用位置，不足的部分按整块 buffer 补齐
+    template <class T, class Alloc>
+    void
+    deque<T, Alloc>::reserve_elements_at_back(size_type n){
+        const size_type vacancies = __finish().last - __finish().cur - 1;
+        if (n > vacancies){
+            expand_at_back((n - vacancies + buffer_size() - 1) / buffer_size());
+        }
+    }
+
+    template <class T, class Alloc>
+    void
+    deque<T, Alloc>::reserve_elements_at_front(size_type n){
+        const size_type vacancies = __start().cur - __start().first;
+        if (n > vacancies){
+            expand_at_front((n - vacancies + buffer_size() - 1) / buffer_size());
+        }
+    }
+
     template <class T, class Alloc>
     void
     deque<T, Alloc>::reserve_map_at_back(size_type nodes_to_add){
@@ -775,12 +857,22 @@ namespace pocket_stl{
                 pocket_stl::copy(__start().node, __finish().node + 1, new_nstart);
             }
             else{
-                pocket_stl::copy_backward(__start().node, __finish().node, new_nstart + old_num_nodes);
+                pocket_stl::copy_backward(__start().node, __finish().node + 1, new_nstart + old_num_nodes);
+            }
+            // 清空搬移后空出的槽位，避免同一缓冲区在 map 中出现两次
+            for (map_pointer cur = __map; cur != new_nstart; ++cur){
+                *cur = nullptr;
+            }
+            for (map_pointer cur = new_nstart + old_num_nodes; cur != __map + __map_size; ++cur){
+                *cur = nullptr;
             }
         }
         else{
             size_type new_map_size = __map_size + std::max(__map_size, nodes_to_add) + 2;
             map_pointer new_map = __map_allocator().allocate(new_map_size);
+            for (size_type i = 0; i < new_map_size; ++i){
+                *(new_map + i) = nullptr;
+            }
             new_nstart = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
             pocket_stl::copy(__start().node, __finish().node + 1, new_nstart);
             __map_allocator().deallocate(__map, __map_size);
@@ -797,8 +889,25 @@ namespace pocket_stl{
     deque<T, Alloc>::insert_aux(iterator pos, Args&&... args){
         const size_type elems_before = pos - __start();
         value_type val_cp = value_type(std::forward<Args>(args)...);
+        if (is_trivially_relocatable<T>::value){
+            // 在较短的一侧腾出一个未初始化的位置，整段 memmove 后在 pos 处构造
+            if(elems_before < size() / 2){
+                if (__start().cur == __start().first) expand_at_front();
+                iterator new_start = __start() - 1;
+                relocate_segments(__start(), __start() + elems_before, new_start);
+                __start() = new_start;
+            }
+            else{
+                if (__finish().cur == __finish().last - 1) expand_at_back();
+                relocate_segments_backward(__start() + elems_before, __finish(), __finish() + 1);
+                ++__finish();
+            }
+            pos = __start() + elems_before;
+            __data_allocator().construct(pos.cur, std::move(val_cp));
+            return pos;
+        }
         if(elems_before < size() / 2){
-            emplace_front(front());
+            emplace_front(std::move(front()));
             iterator front1 = __start();
             ++front1;
             iterator front2 = front1;
@@ -806,16 +915,16 @@ namespace pocket_stl{
             pos = __start() + elems_before;
             iterator pos1 = pos;
             ++pos1;
-            pocket_stl::copy(front2, pos1, front1);
+            pocket_stl::move(front2, pos1, front1);
         }
         else{
-            emplace_back(back());
+            emplace_back(std::move(back()));
             iterator back1 = __finish();
             --back1;
             iterator back2 = back1;
             --back2;
             pos = __start() + elems_before;
-            pocket_stl::copy_backward(pos, back2, back1);
+            pocket_stl::move_backward(pos, back2, back1);
         }
         *pos = std::move(val_cp);
         return pos;
@@ -827,28 +936,26 @@ namespace pocket_stl{
         const size_type elems_before = pos - __start();
         const size_type len = size();
         if(elems_before < (len >> 1)){
-            size_type nodes_to_add = (n - (__start().cur - __start().first)) / buffer_size();
-            expand_at_front(nodes_to_add);
+            reserve_elements_at_front(n);
             auto old_start = __start();
             auto new_start = __start() - n;
             pos = __start() + elems_before;
 
             if(elems_before >= n){
                 auto begin = __start() + n;
-                uninitialized_copy(__start(), begin, new_start);
+                pocket_stl::uninitialized_move(__start(), begin, new_start);
                 __start() = new_start;
-                pocket_stl::copy(begin, pos, old_start);
+                pocket_stl::move(begin, pos, old_start);
                 pocket_stl::fill(pos - n, pos, val);
             }
             else{
-                uninitialized_fill(uninitialized_copy(__start(), pos, new_start), __start(), val);
+                pocket_stl::uninitialized_fill(pocket_stl::uninitialized_move(__start(), pos, new_start), __start(), val);
                 __start() = new_start;
                 pocket_stl::fill(old_start, pos, val);
             }
         }
         else{
-            size_type nodes_to_add = (n - (__finish().last - __start().cur) + 1) / buffer_size();
-            expand_at_back(nodes_to_add);
+            reserve_elements_at_back(n);
             auto old_finish = __finish();
             auto new_finish = __finish() + n;
             const size_type elems_after = len - elems_before;
@@ -856,14 +963,14 @@ namespace pocket_stl{
 
             if(elems_after > n){
                 auto end = __finish() - n;
-                uninitialized_copy(end, __finish(), __finish());
+                pocket_stl::uninitialized_move(end, __finish(), __finish());
                 __finish() = new_finish;
-                pocket_stl::copy_backward(pos, end, old_finish);
+                pocket_stl::move_backward(pos, end, old_finish);
                 pocket_stl::fill(pos, pos + n, val);
             }
             else{
-                uninitialized_fill(__finish(), pos + n, val);
-                uninitialized_copy(pos, __finish(), pos + n);
+                pocket_stl::uninitialized_fill(__finish(), pos + n, val);
+                pocket_stl::uninitialized_move(pos, __finish(), pos + n);
                 __finish() = new_finish;
                 pocket_stl::fill(pos, old_finish, val);
             }
@@ -878,30 +985,28 @@ namespace pocket_stl{
         const size_type elems_before = pos - __start();
         auto len = size();
         if(elems_before < (len >> 1)){
-            size_type nodes_to_add = (n - (__start().cur - __start().first)) / buffer_size();
-            expand_at_front(nodes_to_add);
+            reserve_elements_at_front(n);
             auto old_start = __start();
             auto new_start = __start() - n;
             pos = __start() + elems_before;
 
             if(elems_before >= n){
                 auto begin = __start() + n;
-                uninitialized_copy(__start(), begin, new_start);
+                pocket_stl::uninitialized_move(__start(), begin, new_start);
                 __start() = new_start;
-                pocket_stl::copy(begin, pos, old_start);
+                pocket_stl::move(begin, pos, old_start);
                 pocket_stl::copy(first, last, pos - n);
             }
             else{
                 auto mid = first;
                 std::advance(mid, n - elems_before);
-                uninitialized_copy(first, mid, uninitialized_copy(__start(), pos, new_start));
+                pocket_stl::uninitialized_copy(first, mid, pocket_stl::uninitialized_move(__start(), pos, new_start));
                 __start() = new_start;
                 pocket_stl::copy(mid, last, old_start);
             }
         }
         else{
-            size_type nodes_to_add = (n - (__finish().last - __start().cur) + 1) / buffer_size();
-            expand_at_back(nodes_to_add);
+            reserve_elements_at_back(n);
             auto old_finish = __finish();
             auto new_finish = __finish() + n;
             const size_type elems_after = len - elems_before;
@@ -909,15 +1014,15 @@ namespace pocket_stl{
 
             if(elems_after > n){
                 auto end = __finish() - n;
-                uninitialized_copy(end, __finish(), __finish());
+                pocket_stl::uninitialized_move(end, __finish(), __finish());
                 __finish() = new_finish;
-                pocket_stl::copy_backward(pos, end, old_finish);
+                pocket_stl::move_backward(pos, end, old_finish);
                 pocket_stl::copy(first, last, pos);
             }
             else{
                 auto mid = first;
                 std::advance(mid, elems_after);
-                uninitialized_copy(pos, __finish(), uninitialized_copy(mid, last, __finish()));
+                pocket_stl::uninitialized_move(pos, __finish(), pocket_stl::uninitialized_copy(mid, last, __finish()));
                 __finish() = new_finish;
                 pocket_stl::copy(first, mid, pos);
             }
@@ -938,21 +1043,95 @@ namespace pocket_stl{
         *node = nullptr;
     }
 
-    //****************************非成员函数************************************/
-    /****************************relational operator****************************/
+    // 把 [first, last) 搬到 result 开始处，result 在 first 之前或与之不重叠
     template <class T, class Alloc>
-    bool operator== (const deque<T,Alloc>& lhs, const deque<T,Alloc>& rhs){
-        if (lhs.size() != rhs.size()) return false;
-        else{
-            auto litr = lhs.begin();
-            auto ritr = rhs.begin();
-            while(litr != lhs.end()) {
-                if (!(*litr == *ritr)) return false;
-                ++litr;
-                ++ritr;
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::relocate_segments(iterator first, iterator last, iterator result){
+        difference_type n = last - first;
+        while (n > 0){
+            difference_type len = std::min(n, std::min(first.last - first.cur, result.last - result.cur));
+            std::memmove(static_cast<void*>(result.cur), static_cast<const void*>(first.cur), len * sizeof(T));
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // 把 [first, last) 搬到以 result 结束的位置，result 在 last 之后或与之不重叠
+    template <class T, class Alloc>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::relocate_segments_backward(iterator first, iterator last, iterator result){
+        difference_type n = last - first;
+        while (n > 0){
+            // 位于缓冲区起点时，向前的一段在上一个缓冲区的末尾
+            T* lend = last.cur == last.first ? *(last.node - 1) + buffer_size() : last.cur;
+            T* rend = result.cur == result.first ? *(result.node - 1) + buffer_size() : result.cur;
+            difference_type llen = last.cur == last.first ? difference_type(buffer_size()) : last.cur - last.first;
+            difference_type rlen = result.cur == result.first ? difference_type(buffer_size()) : result.cur - result.first;
+            difference_type len = std::min(n, std::min(llen, rlen));
+            std::memmove(static_cast<void*>(rend - len), static_cast<const void*>(lend - len), len * sizeof(T));
+            last -= len;
+            result -= len;
+            n -= len;
+        }
+        return result;
+    }
+
+    //****************************非成员函数************************************/
+    // deque 的区间由若干连续的块组成，按两个区间的块边界切分后，每一段交给指针版本的算法
+    struct __deque_segments{
+        template <class T, class Ref1, class Ptr1, class Ref2, class Ptr2>
+        static bool equal(__deque_iterator<T, Ref1, Ptr1> first1, __deque_iterator<T, Ref1, Ptr1> last1,
+                          __deque_iterator<T, Ref2, Ptr2> first2){
+            ptrdiff_t n = last1 - first1;
+            while (n > 0){
+                const ptrdiff_t len = segment_length(first1, first2, n);
+                if (!pocket_stl::equal(static_cast<const T*>(first1.cur), static_cast<const T*>(first1.cur + len),
+                                       static_cast<const T*>(first2.cur)))
+                    return false;
+                // 最后一段之后不再前进，避免越过 map 中最后一个块
+                if ((n -= len) == 0) break;
+                first1 += len;
+                first2 += len;
             }
             return true;
         }
+
+        template <class T, class Ref1, class Ptr1, class Ref2, class Ptr2>
+        static int lexicographical_compare_3way(__deque_iterator<T, Ref1, Ptr1> first1, __deque_iterator<T, Ref1, Ptr1> last1,
+                                                __deque_iterator<T, Ref2, Ptr2> first2, __deque_iterator<T, Ref2, Ptr2> last2){
+            const ptrdiff_t len1 = last1 - first1;
+            const ptrdiff_t len2 = last2 - first2;
+            ptrdiff_t n = len1 < len2 ? len1 : len2;
+            while (n > 0){
+                const ptrdiff_t len = segment_length(first1, first2, n);
+                const T* p1 = first1.cur;
+                const T* p2 = first2.cur;
+                const int r = pocket_stl::__lexicographical_compare_3way(p1, p1 + len, p2, p2 + len);
+                if (r != 0) return r;
+                if ((n -= len) == 0) break;
+                first1 += len;
+                first2 += len;
+            }
+            return len1 < len2 ? -1 : (len2 < len1 ? 1 : 0);
+        }
+
+    private:
+        // 两个迭代器所在块剩余长度与 n 中的最小值
+        template <class Iter1, class Iter2>
+        static ptrdiff_t segment_length(const Iter1& first1, const Iter2& first2, ptrdiff_t n){
+            const ptrdiff_t r1 = first1.last - first1.cur;
+            const ptrdiff_t r2 = first2.last - first2.cur;
+            const ptrdiff_t len = r1 < r2 ? r1 : r2;
+            return len < n ? len : n;
+        }
+    };
+
+    /****************************relational operator****************************/
+    template <class T, class Alloc>
+    bool operator== (const deque<T,Alloc>& lhs, const deque<T,Alloc>& rhs){
+        return lhs.size() == rhs.size() && __deque_segments::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
     template <class T, class Alloc>
@@ -962,7 +1141,7 @@ namespace pocket_stl{
 
     template <class T, class Alloc>
     bool operator<  (const deque<T,Alloc>& lhs, const deque<T,Alloc>& rhs){
-        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return __deque_segments::lexicographical_compare_3way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()) < 0;
     }
 
     template <class T, class Alloc>
@@ -986,6 +1165,10 @@ namespace pocket_stl{
     }
 
 
+    // map 与缓冲区都分配在堆上，deque 本身可以按位搬移
+    template <class T, class Alloc>
+    struct is_trivially_relocatable<deque<T, Alloc>> : is_trivially_relocatable<Alloc> {};
+
 } // namespace
 
 #endif
\ No newline at end of file
@@ -0,0 +1,444 @@
+#ifndef _POCKET_EXECUTION_H_
+#define _POCKET_EXECUTION_H_
+
+/*
+** execution
+** execution::seq / execution::par 两种执行策略，以及 sort、for_each、transform、reduce、fill、copy 的带策略版本
+** par 版本在进程内共享的线程池上执行，调用线程同样参与计算；区间被切成若干段，
+** deque 等分段迭代器的切分点对齐到块的起点，相邻两段不会写同一个缓冲区
+** 与标准一致，par 版本中用户函数抛出的异常会导致 std::terminate
+** 线程数默认取 std::thread::hardware_concurrency()，可在编译时用 POCKET_PARALLEL_THREADS 指定
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "iterator.h"
+#include "algobase.h"
+#include "algorithm.h"
+#include "numeric.h"
+#include "memory.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace pocket_stl{
+
+    namespace execution{
+        struct sequenced_policy {};
+        struct parallel_policy {};
+
+        constexpr sequenced_policy  seq{};
+        constexpr parallel_policy   par{};
+    }
+
+    template <class T>
+    struct is_execution_policy : public std::false_type {};
+    template <>
+    struct is_execution_policy<execution::sequenced_policy> : public std::true_type {};
+    template <>
+    struct is_execution_policy<execution::parallel_policy> : public std::true_type {};
+
+    /**************************** thread pool ****************************/
+    // 一次并行调用：count 个下标由调用线程和被唤醒的工作线程共同领取
+    struct __parallel_job{
+        std::atomic<size_t>         next;
+        std::atomic<size_t>         done;
+        size_t                      count;
+        std::function<void(size_t)> fn;
+        std::mutex                  mutex;
+        std::condition_variable     finished;
+
+        __parallel_job(size_t n, std::function<void(size_t)> f) : next(0), done(0), count(n), fn(std::move(f)) {}
+
+        void work(){
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)){
+                fn(i);
+                if (done.fetch_add(1) + 1 == count){
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+
+        void wait(){
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this]{ return done.load() == count; });
+        }
+    };
+
+    class __thread_pool{
+    private:
+        vector<std::thread>                     workers;
+        vector<std::shared_ptr<__parallel_job>> pending;    // 每一项代表一个工作线程可以加入的 job
+        std::mutex                              mutex;
+        std::condition_variable                 wakeup;
+        bool                                    stop;
+
+    public:
+        static __thread_pool& instance(){
+            static __thread_pool pool;
+            return pool;
+        }
+
+        // 参与计算的线程数，包括调用线程
+        size_t concurrency() const noexcept { return workers.size() + 1; }
+
+        // 对 [0, n) 中的每个 i 调用 fn(i)，全部完成后返回；可以在 fn 中嵌套调用，
+        // 调用线程总会自己领取剩余的下标，不依赖空闲的工作线程
+        template <class Function>
+        void run(size_t n, Function fn){
+            if (n == 0) return;
+            if (n == 1 || workers.empty()){
+                for (size_t i = 0; i < n; ++i) fn(i);
+                return;
+            }
+            std::shared_ptr<__parallel_job> job =
+                std::make_shared<__parallel_job>(n, [&fn](size_t i) noexcept { fn(i); });
+            const size_t helpers = n - 1 < workers.size() ? n - 1 : workers.size();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = 0; i < helpers; ++i) pending.push_back(job);
+            }
+            if (helpers == 1) wakeup.notify_one();
+            else              wakeup.notify_all();
+            job->work();
+            job->wait();
+        }
+
+    private:
+        __thread_pool() : stop(false){
+#ifdef POCKET_PARALLEL_THREADS
+            const size_t hw = POCKET_PARALLEL_THREADS;
+#else
+            const size_t hw = std::thread::hardware_concurrency();
+#endif
+            const size_t n = hw > 1 ? hw - 1 : 0;
+            workers.reserve(n);
+            for (size_t i = 0; i < n; ++i){
+                workers.emplace_back(&__thread_pool::worker_loop, this);
+            }
+        }
+
+        ~__thread_pool(){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            wakeup.notify_all();
+            for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+        }
+
+        __thread_pool(const __thread_pool&) = delete;
+        __thread_pool& operator=(const __thread_pool&) = delete;
+
+        void worker_loop(){
+            for (;;){
+                std::shared_ptr<__parallel_job> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wakeup.wait(lock, [this]{ return stop || !pending.empty(); });
+                    if (pending.empty()) return;
+                    job = std::move(pending.back());
+                    pending.pop_back();
+                }
+                // job 可能已经由其他线程做完，此时 work 立即返回
+                job->work();
+            }
+        }
+    };
+
+    /**************************** 区间切分 ****************************/
+    enum {
+        __PARALLEL_MIN_CHUNK        = 1 << 14,  // 每段至少的元素个数，更少时并行的开销超过收益
+        __PARALLEL_CHUNKS_PER_THREAD = 4        // 每个线程分到的段数，段多一些可以平衡各段耗时的差异
+    };
+
+    template <class RandomIter>
+    size_t __parallel_chunk_count(RandomIter first, RandomIter last){
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t by_threads = __thread_pool::instance().concurrency() * __PARALLEL_CHUNKS_PER_THREAD;
+        const size_t by_size = n / __PARALLEL_MIN_CHUNK;
+        return by_threads < by_size ? by_threads : by_size;
+    }
+
+    // 分段迭代器的切分点向前对齐到所在块的起点
+    template <class RandomIter>
+    RandomIter __align_split(RandomIter first, RandomIter pos, std::false_type){
+        (void)first;
+        return pos;
+    }
+
+    template <class RandomIter>
+    RandomIter __align_split(RandomIter first, RandomIter pos, std::true_type){
+        typedef __segmented_iterator_traits<RandomIter> traits;
+        if (traits::segment(pos) == traits::segment(first)) return first;
+        return traits::compose(traits::segment(pos), traits::begin(traits::segment(pos)));
+    }
+
+    // 第 i 段的起点，i == chunks 时为 last
+    template <class RandomIter>
+    RandomIter __chunk_begin(RandomIter first, RandomIter last, size_t i, size_t chunks){
+        if (i == 0) return first;
+        if (i == chunks) return last;
+        const size_t n = static_cast<size_t>(last - first);
+        RandomIter pos = first + static_cast<ptrdiff_t>(n / chunks * i + n % chunks * i / chunks);
+        return pocket_stl::__align_split(first, pos, typename __segmented_iterator_traits<RandomIter>::is_segmented());
+    }
+
+    // 把 [first, last) 切成 chunks 段，并行调用 fn(i, chunk_first, chunk_last)；对齐后为空的段跳过
+    template <class RandomIter, class Function>
+    void __parallel_chunks(RandomIter first, RandomIter last, size_t chunks, Function fn){
+        __thread_pool::instance().run(chunks, [&](size_t i){
+            RandomIter b = pocket_stl::__chunk_begin(first, last, i, chunks);
+            RandomIter e = pocket_stl::__chunk_begin(first, last, i + 1, chunks);
+            if (b != e) fn(i, b, e);
+        });
+    }
+
+    /**************************** for_each ****************************/
+    template <class RandomIter, class Function>
+    void for_each(const execution::sequenced_policy&, RandomIter first, RandomIter last, Function f){
+        pocket_stl::for_each(first, last, f);
+    }
+
+    template <class RandomIter, class Function>
+    void for_each(const execution::parallel_policy&, RandomIter first, RandomIter last, Function f){
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first, last);
+        if (chunks <= 1){
+            pocket_stl::for_each(first, last, f);
+            return;
+        }
+        pocket_stl::__parallel_chunks(first, last, chunks, [&](size_t, RandomIter b, RandomIter e){
+            pocket_stl::for_each(b, e, f);
+        });
+    }
+
+    /**************************** transform ****************************/
+    template <class RandomIter, class OutputIter, class UnaryOperation>
+    OutputIter transform(const execution::sequenced_policy&, RandomIter first, RandomIter last,
+                         OutputIter result, UnaryOperation op){
+        return pocket_stl::transform(first, last, result, op);
+    }
+
+    // result 同样需要是随机访问迭代器，每段从 result + (chunk_first - first) 开始写
+    template <class RandomIter, class OutputIter, class UnaryOperation>
+    OutputIter transform(const execution::parallel_policy&, RandomIter first, RandomIter last,
+                         OutputIter result, UnaryOperation op){
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first, last);
+        if (chunks <= 1) return pocket_stl::transform(first, last, result, op);
+        pocket_stl::__parallel_chunks(first, last, chunks, [&](size_t, RandomIter b, RandomIter e){
+            pocket_stl::transform(b, e, result + (b - first), op);
+        });
+        return result + (last - first);
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class BinaryOperation>
+    OutputIter transform(const execution::sequenced_policy&, RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, OutputIter result, BinaryOperation op){
+        return pocket_stl::transform(first1, last1, first2, result, op);
+    }
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class BinaryOperation>
+    OutputIter transform(const execution::parallel_policy&, RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, OutputIter result, BinaryOperation op){
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first1, last1);
+        if (chunks <= 1) return pocket_stl::transform(first1, last1, first2, result, op);
+        pocket_stl::__parallel_chunks(first1, last1, chunks, [&](size_t, RandomIter1 b, RandomIter1 e){
+            pocket_stl::transform(b, e, first2 + (b - first1), result + (b - first1), op);
+        });
+        return result + (last1 - first1);
+    }
+
+    /**************************** reduce ****************************/
+    template <class RandomIter, class T, class BinaryOperation>
+    T reduce(const execution::sequenced_policy&, RandomIter first, RandomIter last, T init, BinaryOperation op){
+        return pocket_stl::reduce(first, last, std::move(init), op);
+    }
+
+    // 每段以自身的第一个元素为初值归约，各段结果再按段的顺序并入 init，相同输入的结果与线程调度无关
+    template <class RandomIter, class T, class BinaryOperation>
+    T reduce(const execution::parallel_policy&, RandomIter first, RandomIter last, T init, BinaryOperation op){
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first, last);
+        if (chunks <= 1) return pocket_stl::reduce(first, last, std::move(init), op);
+        vector<T*> partials(chunks, nullptr);
+        pocket_stl::__parallel_chunks(first, last, chunks, [&](size_t i, RandomIter b, RandomIter e){
+            T acc = *b;
+            partials[i] = new T(pocket_stl::accumulate(++b, e, std::move(acc), op));
+        });
+        for (size_t i = 0; i < chunks; ++i){
+            if (partials[i] == nullptr) continue;
+            init = op(std::move(init), std::move(*partials[i]));
+            delete partials[i];
+        }
+        return init;
+    }
+
+    template <class ExecutionPolicy, class RandomIter, class T>
+    typename std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, T>::type
+    reduce(ExecutionPolicy&& policy, RandomIter first, RandomIter last, T init){
+        return pocket_stl::reduce(policy, first, last, std::move(init), __plus());
+    }
+
+    template <class ExecutionPolicy, class RandomIter>
+    typename std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value,
+                            typename iterator_traits<RandomIter>::value_type>::type
+    reduce(ExecutionPolicy&& policy, RandomIter first, RandomIter last){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        return pocket_stl::reduce(policy, first, last, T(), __plus());
+    }
+
+    /**************************** fill ****************************/
+    template <class RandomIter, class T>
+    void fill(const execution::sequenced_policy&, RandomIter first, RandomIter last, const T& value){
+        pocket_stl::fill(first, last, value);
+    }
+
+    template <class RandomIter, class T>
+    void fill(const execution::parallel_policy&, RandomIter first, RandomIter last, const T& value){
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first, last);
+        if (chunks <= 1){
+            pocket_stl::fill(first, last, value);
+            return;
+        }
+        pocket_stl::__parallel_chunks(first, last, chunks, [&](size_t, RandomIter b, RandomIter e){
+            pocket_stl::fill(b, e, value);
+        });
+    }
+
+    /**************************** copy ****************************/
+    template <class RandomIter, class OutputIter>
+    OutputIter copy(const execution::sequenced_policy&, RandomIter first, RandomIter last, OutputIter result){
+        return pocket_stl::copy(first, last, result);
+    }
+
+    // 两个区间不能重叠
+    template <class RandomIter, class OutputIter>
+    OutputIter copy(const execution::parallel_policy&, RandomIter first, RandomIter last, OutputIter result){
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first, last);
+        if (chunks <= 1) return pocket_stl::copy(first, last, result);
+        pocket_stl::__parallel_chunks(first, last, chunks, [&](size_t, RandomIter b, RandomIter e){
+            pocket_stl::copy(b, e, result + (b - first));
+        });
+        return result + (last - first);
+    }
+
+    /**************************** sort ****************************/
+    // merge path：[a, a + na) 与 [b, b + nb) 归并结果的前 k 个元素中，来自 a 的个数；相等时 a 中的元素在前
+    template <class Iter1, class Iter2, class Compare>
+    ptrdiff_t __merge_path_split(Iter1 a, ptrdiff_t na, Iter2 b, ptrdiff_t nb, ptrdiff_t k, Compare& comp){
+        ptrdiff_t lo = k > nb ? k - nb : 0;
+        ptrdiff_t hi = k < na ? k : na;
+        while (lo < hi){
+            const ptrdiff_t i = lo + (hi - lo) / 2;
+            const ptrdiff_t j = k - i;
+            if (j > 0 && !comp(*(b + (j - 1)), *(a + i))) lo = i + 1;
+            else hi = i;
+        }
+        return lo;
+    }
+
+    // 把 src 中以 bounds 为边界的相邻两段归并到 dst 中相同的位置，每次归并再按 merge path 切成 parts 份并行
+    // 切分点要在归并开始前全部求出：移动会改动源元素（如 string 被移走后变空），二分查找不能与其他份的归并同时进行
+    template <class SrcIter, class DstIter, class Compare>
+    void __parallel_merge_round(SrcIter src, DstIter dst, const vector<ptrdiff_t>& bounds, size_t parts, Compare& comp){
+        const size_t runs = bounds.size() - 1;
+        const size_t pairs = (runs + 1) / 2;
+        vector<ptrdiff_t> splits(pairs * (parts + 1), 0);
+        for (size_t pair = 0; pair < pairs; ++pair){
+            const ptrdiff_t lo = bounds[2 * pair];
+            const ptrdiff_t mid = bounds[2 * pair + 1];
+            const ptrdiff_t hi = 2 * pair + 2 < bounds.size() ? bounds[2 * pair + 2] : mid;
+            for (size_t part = 0; part <= parts; ++part){
+                const ptrdiff_t k = (hi - lo) * static_cast<ptrdiff_t>(part) / static_cast<ptrdiff_t>(parts);
+                splits[pair * (parts + 1) + part] = pocket_stl::__merge_path_split(src + lo, mid - lo, src + mid, hi - mid, k, comp);
+            }
+        }
+        __thread_pool::instance().run(pairs * parts, [&](size_t task){
+            const size_t pair = task / parts;
+            const size_t part = task % parts;
+            const ptrdiff_t lo = bounds[2 * pair];
+            const ptrdiff_t mid = bounds[2 * pair + 1];
+            const ptrdiff_t hi = 2 * pair + 2 < bounds.size() ? bounds[2 * pair + 2] : mid;
+            const ptrdiff_t k0 = (hi - lo) * static_cast<ptrdiff_t>(part) / static_cast<ptrdiff_t>(parts);
+            const ptrdiff_t k1 = (hi - lo) * static_cast<ptrdiff_t>(part + 1) / static_cast<ptrdiff_t>(parts);
+            const ptrdiff_t i0 = splits[pair * (parts + 1) + part];
+            const ptrdiff_t i1 = splits[pair * (parts + 1) + part + 1];
+            pocket_stl::__move_merge(src + (lo + i0), src + (lo + i1),
+                                     src + (mid + (k0 - i0)), src + (mid + (k1 - i1)),
+                                     dst + (lo + k0), comp);
+        });
+    }
+
+    template <class RandomIter, class Compare>
+    void sort(const execution::sequenced_policy&, RandomIter first, RandomIter last, Compare comp){
+        pocket_stl::sort(first, last, comp);
+    }
+
+    // 各段并行地 pdqsort，再逐轮两两归并；归并在区间与等长的临时缓冲区之间交替进行，
+    // 每次归并按 merge path 切成多份并行，最后一轮也能用上所有线程
+    template <class RandomIter, class Compare>
+    void sort(const execution::parallel_policy&, RandomIter first, RandomIter last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        const size_t chunks = pocket_stl::__parallel_chunk_count(first, last);
+        const size_t threads = __thread_pool::instance().concurrency();
+        const size_t runs = chunks < threads ? chunks : threads;
+        if (runs <= 1){
+            pocket_stl::sort(first, last, comp);
+            return;
+        }
+        const ptrdiff_t len = last - first;
+        std::pair<T*, ptrdiff_t> buf = pocket_stl::get_temporary_buffer<T>(len);
+        if (buf.second < len){
+            pocket_stl::release_temporary_buffer(buf.first);
+            pocket_stl::sort(first, last, comp);
+            return;
+        }
+
+        vector<ptrdiff_t> bounds;
+        for (size_t i = 0; i <= runs; ++i){
+            bounds.push_back(len * static_cast<ptrdiff_t>(i) / static_cast<ptrdiff_t>(runs));
+        }
+        __thread_pool::instance().run(runs, [&](size_t i){
+            pocket_stl::sort(first + bounds[i], first + bounds[i + 1], comp);
+            pocket_stl::uninitialized_move(first + bounds[i], first + bounds[i + 1], buf.first + bounds[i]);
+        });
+
+        // 数据先在缓冲区中，每一轮在两者之间来回
+        bool in_buffer = true;
+        while (bounds.size() > 2){
+            const size_t pairs = bounds.size() / 2;
+            const size_t parts = threads / pairs > 0 ? threads / pairs : 1;
+            if (in_buffer) pocket_stl::__parallel_merge_round(buf.first, first, bounds, parts, comp);
+            else           pocket_stl::__parallel_merge_round(first, buf.first, bounds, parts, comp);
+            in_buffer = !in_buffer;
+            vector<ptrdiff_t> next;
+            for (size_t i = 0; i < bounds.size(); i += 2) next.push_back(bounds[i]);
+            if (next.back() != len) next.push_back(len);
+            bounds.swap(next);
+        }
+
+        if (in_buffer){
+            T* src = buf.first;
+            pocket_stl::__parallel_chunks(first, last, chunks, [&](size_t, RandomIter b, RandomIter e){
+                pocket_stl::move(src + (b - first), src + (e - first), b);
+            });
+        }
+        pocket_stl::destroy(buf.first, buf.first + len);
+        pocket_stl::release_temporary_buffer(buf.first);
+    }
+
+    template <class ExecutionPolicy, class RandomIter>
+    typename std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value>::type
+    sort(ExecutionPolicy&& policy, RandomIter first, RandomIter last){
+        pocket_stl::sort(policy, first, last, __less());
+    }
+
+}
+
+#endif
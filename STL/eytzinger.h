@@ -0,0 +1,116 @@
+#ifndef _POCKET_EYTZINGER_H_
+#define _POCKET_EYTZINGER_H_
+
+/*
+** eytzinger_index
+** 把有序序列按二叉堆的层序（Eytzinger 布局）重新排列，下标 k 的两个子节点是 2k 与 2k + 1
+** 查找路径上前几层的元素集中在数组开头，常驻缓存；每次比较只决定下一个下标，没有分支
+** 数组按 cache line 对齐，k 之下若干层的后代在同一条 cache line 中，查找时提前预取，
+** 把逐层的缓存缺失重叠起来，表大于 L2 时比有序数组上的二分查找快数倍
+** 只读：建好后不支持插入与删除
+*/
+
+#include <cstddef>
+#include "iterator.h"
+#include "functional.h"
+#include "aligned_allocator.h"
+#include "vector.h"
+
+namespace pocket_stl{
+
+    enum { __EYTZINGER_CACHELINE = 64 };
+
+    template <class T, class Compare = less<T>>
+    class eytzinger_index{
+    public:
+        typedef T               value_type;
+        typedef Compare         value_compare;
+        typedef size_t          size_type;
+        typedef const T*        const_pointer;
+
+    private:
+        // __tree[0] 不使用，根在 __tree[1]
+        vector<T, aligned_allocator<T, __EYTZINGER_CACHELINE>> __tree;
+        size_type   __size;
+        Compare     __comp;
+
+        // 一条 cache line 能放下的元素个数，k 往下这么多个后代是 [k * stride, k * stride + stride)
+        static constexpr size_type __prefetch_stride =
+            sizeof(T) >= __EYTZINGER_CACHELINE ? 1 : __EYTZINGER_CACHELINE / sizeof(T);
+
+    public:
+        // [first, last) 必须按 comp 有序
+        template <class RandomIter>
+        eytzinger_index(RandomIter first, RandomIter last, const Compare& comp = Compare())
+            : __tree(), __size(static_cast<size_type>(last - first)), __comp(comp){
+            if (__size == 0) return;
+            __tree.resize(__size + 1, *first);
+            __build(first, 0, 1);
+        }
+
+        explicit eytzinger_index(const vector<T>& sorted, const Compare& comp = Compare())
+            : eytzinger_index(sorted.begin(), sorted.end(), comp) {}
+
+        size_type   size()  const noexcept { return __size; }
+        bool        empty() const noexcept { return __size == 0; }
+
+        // 第一个不小于 value 的元素，不存在时返回 nullptr
+        const_pointer lower_bound(const value_type& value) const{
+            size_type k = 1;
+            while (k <= __size){
+                __prefetch(k);
+                k = 2 * k + size_type(__comp(__tree[k], value));
+            }
+            return __result(k);
+        }
+
+        // 第一个大于 value 的元素，不存在时返回 nullptr
+        const_pointer upper_bound(const value_type& value) const{
+            size_type k = 1;
+            while (k <= __size){
+                __prefetch(k);
+                k = 2 * k + size_type(!__comp(value, __tree[k]));
+            }
+            return __result(k);
+        }
+
+        bool contains(const value_type& value) const{
+            const_pointer p = lower_bound(value);
+            return p != nullptr && !__comp(value, *p);
+        }
+
+    private:
+        // 按中序遍历把有序序列依次填入，返回下一个待填的有序下标
+        template <class RandomIter>
+        size_type __build(RandomIter first, size_type i, size_type k){
+            if (k <= __size){
+                i = __build(first, i, 2 * k);
+                __tree[k] = *(first + i++);
+                i = __build(first, i, 2 * k + 1);
+            }
+            return i;
+        }
+
+        void __prefetch(size_type k) const noexcept{
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(__tree.data() + k * __prefetch_stride);
+#else
+            (void)k;
+#endif
+        }
+
+        // 路径最后一次向左走的节点就是答案：去掉 k 末尾连续的 1 以及再前面的一个 0
+        const_pointer __result(size_type k) const noexcept{
+#if defined(__GNUC__) || defined(__clang__)
+            k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+#else
+            while (k & 1) k >>= 1;
+            k >>= 1;
+#endif
+            return k == 0 ? nullptr : __tree.data() + k;
+        }
+    };
+
+}
+
+#endif
@@ -31,6 +31,16 @@ namespace pocket_stl{
         bool operator()(const T& x, const T& y) const { return x == y; }
     };
 
+    template <class T>
+    struct less :public binary_function<T, T, bool>{
+        bool operator()(const T& x, const T& y) const { return x < y; }
+    };
+
+    template <class T>
+    struct greater :public binary_function<T, T, bool>{
+        bool operator()(const T& x, const T& y) const { return x > y; }
+    };
+
     /**************************** hash function *****************************/
     // 对于大部分类型，hash function 什么都不做
     template <class Key>
@@ -9,8 +9,10 @@
 #include <cstddef>
 #include <cmath>
 #include <stdexcept>
+#include <type_traits>
 #include "allocator.h"
 #include "algobase.h"
+#include "functional.h"
 #include "vector.h"
 
 #define HASHTABLE __hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc>
@@ -88,13 +90,21 @@ namespace pocket_stl{
         __hashtable_node* next;
         Value val;
         __hashtable_node() : next(nullptr) {}
-        __hashtable_node(const Value& v) : val(v), next(nullptr) {}
+        __hashtable_node(const Value& v) : next(nullptr), val(v) {}
+        __hashtable_node(Value&& v) : next(nullptr), val(std::move(v)) {}
         __hashtable_node(const __hashtable_node& node) : next(node.next), val(node.val) {}
-        __hashtable_node(__hashtable_node&& node) : next(node.next), val(std::move(node.next)) {
+        __hashtable_node(__hashtable_node&& node) : next(node.next), val(std::move(node.val)) {
             node.next = nullptr;
         }
     };
     
+    // 节点从 hashtable 自己持有的 slab 中切分，每块 slab 的头部记录下一块 slab 与本块的大小
+    // erase 回收的节点进入 free list 以供复用，clear() 与析构时整块归还 slab，不再逐个释放节点
+    struct __hashtable_slab{
+        __hashtable_slab*   next;
+        size_t              capacity;       // 按节点个数计的大小，包括头部所占的位置
+    };
+
     // HashFcn : HashFunction的函数型别
     // ExtractKey : 从节点中取出键值的方法
     // EqualKey : 判断键值相同与否
@@ -219,9 +229,10 @@ namespace pocket_stl{
         ExtractKey get_key;
 
         using node                  = __hashtable_node<Value>;
-        using node_allocator_type   = typename Alloc::template rebind<Value*>::other;
+        using node_allocator_type   = typename Alloc::template rebind<node>::other;
+        using bucket_type           = vector<node*, typename Alloc::template rebind<node*>::other>;
 
-        vector<node*, Alloc> buckets;
+        bucket_type buckets;
         float mlf; // max load factor
         compressed_pair<size_type, node_allocator_type> num_and_node_allocator;
         compressed_pair<size_type, node_allocator_type>&        node_allocator() noexcept{ return num_and_node_allocator; }
@@ -229,24 +240,39 @@ namespace pocket_stl{
         size_type&          num_elements() noexcept { return num_and_node_allocator.data; }
         const size_type&    num_elements() const noexcept { return num_and_node_allocator.data; }
 
+        enum { __MIN_SLAB_NODES = 16 };
+        enum { __MAX_SLAB_BYTES = 1 << 20 };
+
+        __hashtable_slab*   slabs = nullptr;        // 已申请的 slab
+        node*               free_nodes = nullptr;   // erase 回收的节点，以 next 串起
+        node*               slab_cur = nullptr;     // 当前 slab 中下一个未使用的节点
+        node*               slab_end = nullptr;
+
     public:
-        explicit __hashtable(size_type n, const HashFcn& hf = hasher(), const EqualKey& eql = key_equal())
-                : hash(hf), equals(eql), mlf(1.0f), get_key(ExtractKey()){
-            num_elements() = 0;
+        explicit __hashtable(size_type n, const HashFcn& hf = hasher(), const EqualKey& eql = key_equal(),
+                             const allocator_type& alloc = allocator_type())
+                : hash(hf), equals(eql), get_key(ExtractKey()), buckets(alloc), mlf(1.0f),
+                  num_and_node_allocator(0, alloc){
             initialize_buckets(n);
         }
 
+        // 复制 rhs 的 allocator
         __hashtable(const __hashtable& rhs)
-            :  mlf(1.0f), hash(rhs.hash), equals(rhs.equals), get_key(rhs.get_key){
-            num_elements() = 0;
+            : hash(rhs.hash), equals(rhs.equals), get_key(rhs.get_key), buckets(rhs.buckets.get_allocator()),
+              mlf(1.0f), num_and_node_allocator(0, rhs.node_allocator().get_allocator()){
             copy_from(rhs);
         }
 
         __hashtable(__hashtable&& rhs) noexcept
-                : buckets(std::move(rhs.buckets)), mlf(rhs.mlf), hash(rhs.hash), equals(rhs.equals), get_key(rhs.get_key){
-            num_elements() = rhs.num_elements();
-            rhs.num_elements = 0;
+                : hash(rhs.hash), equals(rhs.equals), get_key(rhs.get_key), buckets(std::move(rhs.buckets)),
+                  mlf(rhs.mlf), num_and_node_allocator(rhs.num_elements(), rhs.node_allocator().get_allocator()),
+                  slabs(rhs.slabs), free_nodes(rhs.free_nodes), slab_cur(rhs.slab_cur), slab_end(rhs.slab_end){
+            rhs.num_elements() = 0;
             rhs.mlf = 0.0f;
+            rhs.slabs = nullptr;
+            rhs.free_nodes = nullptr;
+            rhs.slab_cur = nullptr;
+            rhs.slab_end = nullptr;
         }
 
         template <class InputIterator, class = typename std::enable_if<
@@ -290,7 +316,7 @@ namespace pocket_stl{
         }      
 
     public:
-        size_type   size() { return num_elements(); }
+        size_type   size() const { return num_elements(); }
         size_type   max_size() const { return size_type(-1); }
         bool        empty() const { return size() == 0; }
         void        swap(__hashtable& rhs);
@@ -337,14 +363,16 @@ namespace pocket_stl{
 
         hasher hash_function() const { return hash; }
         key_equal key_eq() const { return equals; }
-        allocator_type get_allocator() const noexcept { return allocator_type(); }
+        allocator_type get_allocator() const noexcept { return allocator_type(node_allocator().get_allocator()); }
 
     private:
         /************************** 辅助工具 *****************************/
-        inline size_type __stl_next_prime(size_type n) noexcept;
+        inline size_type __stl_next_prime(size_type n) const noexcept;
         template <class... Args>
         node* new_node(Args&&... arg);
         void delete_node(node* n);
+        void add_slab(size_type n);
+        void release_slabs() noexcept;
         void initialize_buckets(size_type n);
         void copy_from(const __hashtable& ht);
         size_type next_size(size_type n) const { return __stl_next_prime(n); }
@@ -355,7 +383,7 @@ namespace pocket_stl{
         std::pair<iterator, bool> insert_node_unique(node* ptr);
         iterator insert_node_equal(node* ptr);
         size_type bkt_num(const value_type& obj, size_t n) const { return bkt_num_key(get_key(obj), n); }   // 确定元素落脚处，接收实值和 buckets 个数
-        size_type bkt_num(const value_type& obj) const { return bkt_num(get_key(obj)); }
+        size_type bkt_num(const value_type& obj) const { return bkt_num_key(get_key(obj)); }
         size_type bkt_num_key(const key_type& key) const { return bkt_num_key(key, buckets.size()); }
         size_type bkt_num_key(const key_type& key, size_t n) const { return hash(key) % n; }
         void erase_bucket(const size_type n, node* first, node* last);
@@ -371,7 +399,13 @@ namespace pocket_stl{
         std::swap(equals, rhs.equals);
         std::swap(get_key, rhs.get_key);
         buckets.swap(rhs.buckets);
+        std::swap(mlf, rhs.mlf);
         std::swap(num_elements(), rhs.num_elements());
+        std::swap(node_allocator().get_allocator(), rhs.node_allocator().get_allocator());
+        std::swap(slabs, rhs.slabs);
+        std::swap(free_nodes, rhs.free_nodes);
+        std::swap(slab_cur, rhs.slab_cur);
+        std::swap(slab_end, rhs.slab_end);
     }
 
     template <class Value, class Key, class HashFcn,
@@ -651,7 +685,7 @@ namespace pocket_stl{
     HASHTABLE::erase(const_iterator first, const_iterator last){
         size_type f_bucket = first.cur ? bkt_num(first.cur->val) : buckets.size();
         size_type l_bucket = last.cur ? bkt_num(last.cur->val) : buckets.size();
-        if (first.cur == last.cur) return;
+        if (first.cur == last.cur) return iterator(last.cur, this);
         else if(f_bucket == l_bucket)
             erase_bucket(f_bucket, first.cur, last.cur);
         else{
@@ -661,6 +695,7 @@ namespace pocket_stl{
             }
             if (l_bucket != buckets.size()) erase_bucket(l_bucket, last.cur);
         }
+        return iterator(last.cur, this);
     }
 
     template <class Value, class Key, class HashFcn,
@@ -684,15 +719,16 @@ namespace pocket_stl{
                 class ExtractKey, class EqualKey, class Alloc>
     void
     HASHTABLE::clear() noexcept{
-        for (size_type i = 0; i < buckets.size(); ++i){
-            node* cur = buckets[i];
-            while(cur != nullptr){
-                node* next = cur->next;
-                delete_node(cur);
-                cur = next;
+        // 节点的空间随 slab 整块归还，只有元素需要析构时才逐个访问节点
+        if (!std::is_trivially_destructible<Value>::value){
+            for (size_type i = 0; i < buckets.size(); ++i){
+                for (node* cur = buckets[i]; cur != nullptr; cur = cur->next){
+                    pocket_stl::destroy(&cur->val);
+                }
             }
-            buckets[i] = nullptr;
         }
+        pocket_stl::fill(buckets.begin(), buckets.end(), static_cast<node*>(nullptr));
+        release_slabs();
         num_elements() = 0;
     }
 
@@ -700,7 +736,7 @@ namespace pocket_stl{
     template <class Value, class Key, class HashFcn,
                 class ExtractKey, class EqualKey, class Alloc>
     inline typename HASHTABLE::size_type 
-    HASHTABLE::__stl_next_prime(size_type n) noexcept {
+    HASHTABLE::__stl_next_prime(size_type n) const noexcept {
         const size_type* first = __stl_prime_list;
         const size_type* last = __stl_prime_list + __stl_num_primes;
         const size_type* pos = std::lower_bound(first, last, n);
@@ -712,14 +748,28 @@ namespace pocket_stl{
     template <class... Args>
     typename HASHTABLE::node*
     HASHTABLE::new_node(Args&&... arg){
-        node* n = node_allocator().allocate(1);
+        node* n;
+        if (free_nodes != nullptr){
+            n = free_nodes;
+            free_nodes = n->next;
+        }
+        else{
+            if (slab_cur == slab_end){
+                // slab 的大小随元素个数增长，单块不超过 __MAX_SLAB_BYTES
+                const size_type max_nodes = std::max(size_type(__MIN_SLAB_NODES), size_type(__MAX_SLAB_BYTES / sizeof(node)));
+                add_slab(std::max(size_type(__MIN_SLAB_NODES), std::min(num_elements(), max_nodes)));
+            }
+            n = slab_cur++;
+        }
         n->next = nullptr;
         try{
-            node_allocator().construct(&n->val, std::forward<Args>(arg)...);
+            pocket_stl::construct(&n->val, std::forward<Args>(arg)...);
             return n;
         }
         catch(...){
-            node_allocator().deallocate(n);
+            n->next = free_nodes;
+            free_nodes = n;
+            throw;
         }
     }
 
@@ -727,8 +777,38 @@ namespace pocket_stl{
                 class ExtractKey, class EqualKey, class Alloc>
     void
     HASHTABLE::delete_node(node* n){
-        destroy(&n->val);
-        node_allocator().deallocate(n);
+        pocket_stl::destroy(&n->val);
+        n->next = free_nodes;
+        free_nodes = n;
+    }
+
+    // 申请一块可容纳 n 个节点的 slab，头部占用开头的若干个节点位置
+    template <class Value, class Key, class HashFcn,
+                class ExtractKey, class EqualKey, class Alloc>
+    void
+    HASHTABLE::add_slab(size_type n){
+        const size_type header = (sizeof(__hashtable_slab) + sizeof(node) - 1) / sizeof(node);
+        node* p = node_allocator().allocate(header + n);
+        __hashtable_slab* slab = reinterpret_cast<__hashtable_slab*>(p);
+        slab->next = slabs;
+        slab->capacity = header + n;
+        slabs = slab;
+        slab_cur = p + header;
+        slab_end = slab_cur + n;
+    }
+
+    template <class Value, class Key, class HashFcn,
+                class ExtractKey, class EqualKey, class Alloc>
+    void
+    HASHTABLE::release_slabs() noexcept{
+        while (slabs != nullptr){
+            __hashtable_slab* next = slabs->next;
+            node_allocator().deallocate(reinterpret_cast<node*>(slabs), slabs->capacity);
+            slabs = next;
+        }
+        free_nodes = nullptr;
+        slab_cur = nullptr;
+        slab_end = nullptr;
     }
 
     template <class Value, class Key, class HashFcn,
@@ -736,7 +816,7 @@ namespace pocket_stl{
     void
     HASHTABLE::initialize_buckets(size_type n){
         const size_type n_buckets = next_size(n);
-        buckets.reverse(n_buckets);
+        buckets.reserve(n_buckets);
         buckets.insert(buckets.end(), n_buckets, (node*)nullptr);
         num_elements() = 0;
     }
@@ -746,9 +826,12 @@ namespace pocket_stl{
     void
     HASHTABLE::copy_from(const __hashtable& ht){
         // 若己方空间大于对方，则不变，否则增大
+        buckets.clear();
         buckets.reserve(ht.buckets.size());
         buckets.insert(buckets.end(), ht.buckets.size(), static_cast<node*>(nullptr));
         try{
+            // 所有节点从一块与 ht.size() 等大的 slab 中切分
+            if (ht.num_elements() > size_type(slab_end - slab_cur)) add_slab(ht.num_elements());
             for (size_type i = 0; i < ht.buckets.size(); ++i){
                 if(const node* cur = ht.buckets[i]){
                     node* copy = new_node(cur->val);
@@ -774,7 +857,7 @@ namespace pocket_stl{
         if (num_elements_hint > old_n) {  //确定是否需要重新配置，新增后元素个数大于 buckets 大小，则扩充
             const size_type n = next_size(num_elements_hint);
             if (n > old_n) {
-                vector<node*> tmp(n, static_cast<node*>(nullptr)); // 设立新的 buckets
+                bucket_type tmp(n, static_cast<node*>(nullptr), buckets.get_allocator()); // 设立新的 buckets
                 try {
                     // 以下处理每一个旧的 bucket
                     for (size_type bucket = 0; bucket < old_n; ++bucket) {
@@ -854,14 +937,15 @@ namespace pocket_stl{
         else{
             for (; cur; cur = cur->next){
                 if(equals(get_key(cur->val), get_key(ptr->val))){
-                    return make_pair(iterator(ptr, this), false);
+                    delete_node(ptr);
+                    return std::make_pair(iterator(cur, this), false);
                 }
             }
             ptr->next = buckets[n];
             buckets[n] = ptr;
         }
         ++num_elements();
-        return make_pair(iterator(ptr, this), true);
+        return std::make_pair(iterator(ptr, this), true);
     }
 
     template <class Value, class Key, class HashFcn,
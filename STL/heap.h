@@ -0,0 +1,180 @@
+#ifndef _POCKET_HEAP_H_
+#define _POCKET_HEAP_H_
+
+/*
+** heap
+** push_heap / pop_heap / make_heap / sort_heap / is_heap / is_heap_until，默认建大根堆
+** 内部实现以分叉数 Arity 为模板参数：对外的算法是二叉堆，priority_queue 还可以选用 4 叉堆，
+** 层数减半，下沉时移动的次数减半，代价是每层多两次比较
+*/
+
+#include <cstddef>
+#include <utility>
+#include "iterator.h"
+#include "algobase.h"
+
+namespace pocket_stl{
+
+    /**************************** 上浮与下沉 ****************************/
+    // 空位 hole 沿父节点上浮，直到 top 或父节点不小于 value
+    template <size_t Arity, class RandomIter, class Distance, class T, class Compare>
+    void __push_heap_aux(RandomIter first, Distance hole, Distance top, T value, Compare& comp){
+        Distance parent = (hole - 1) / Distance(Arity);
+        while (hole > top && comp(*(first + parent), value)){
+            *(first + hole) = std::move(*(first + parent));
+            hole = parent;
+            parent = (hole - 1) / Distance(Arity);
+        }
+        *(first + hole) = std::move(value);
+    }
+
+    // 把 value 放入以 hole 为根、长度为 len 的堆中：先让空位沿最大的子节点下沉到底，再上浮
+    // 下沉时每层只比较子节点之间的大小，比逐层与 value 比较少一半左右的比较
+    template <size_t Arity, class RandomIter, class Distance, class T, class Compare>
+    void __adjust_heap(RandomIter first, Distance hole, Distance len, T value, Compare& comp){
+        const Distance top = hole;
+        Distance child = Distance(Arity) * hole + 1;
+        while (len - child >= Distance(Arity)){
+            Distance best = child;
+            for (Distance c = child + 1; c < child + Distance(Arity); ++c){
+                if (comp(*(first + best), *(first + c))) best = c;
+            }
+            *(first + hole) = std::move(*(first + best));
+            hole = best;
+            child = Distance(Arity) * hole + 1;
+        }
+        // 最后一个不满的节点，它的子节点都在 len 之外
+        if (child < len){
+            Distance best = child;
+            for (Distance c = child + 1; c < len; ++c){
+                if (comp(*(first + best), *(first + c))) best = c;
+            }
+            *(first + hole) = std::move(*(first + best));
+            hole = best;
+        }
+        pocket_stl::__push_heap_aux<Arity>(first, hole, top, std::move(value), comp);
+    }
+
+    /**************************** 以 Arity 为参数的实现 ****************************/
+    // [first, last - 1) 是堆，把 *(last - 1) 加入
+    template <size_t Arity, class RandomIter, class Compare>
+    void __push_heap(RandomIter first, RandomIter last, Compare& comp){
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        typedef typename iterator_traits<RandomIter>::value_type       T;
+        const Distance len = last - first;
+        if (len < 2) return;
+        T value = std::move(*(last - 1));
+        pocket_stl::__push_heap_aux<Arity>(first, len - 1, Distance(0), std::move(value), comp);
+    }
+
+    // 把堆顶移到 last - 1，[first, last - 1) 仍是堆
+    template <size_t Arity, class RandomIter, class Compare>
+    void __pop_heap(RandomIter first, RandomIter last, Compare& comp){
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        typedef typename iterator_traits<RandomIter>::value_type       T;
+        const Distance len = last - first;
+        if (len < 2) return;
+        T value = std::move(*(last - 1));
+        *(last - 1) = std::move(*first);
+        pocket_stl::__adjust_heap<Arity>(first, Distance(0), len - 1, std::move(value), comp);
+    }
+
+    // 自底向上逐个调整非叶节点，O(n)
+    template <size_t Arity, class RandomIter, class Compare>
+    void __make_heap(RandomIter first, RandomIter last, Compare& comp){
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        typedef typename iterator_traits<RandomIter>::value_type       T;
+        const Distance len = last - first;
+        if (len < 2) return;
+        for (Distance parent = (len - 2) / Distance(Arity); ; --parent){
+            T value = std::move(*(first + parent));
+            pocket_stl::__adjust_heap<Arity>(first, parent, len, std::move(value), comp);
+            if (parent == 0) break;
+        }
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    void __sort_heap(RandomIter first, RandomIter last, Compare& comp){
+        for (; last - first > 1; --last){
+            pocket_stl::__pop_heap<Arity>(first, last, comp);
+        }
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    RandomIter __is_heap_until(RandomIter first, RandomIter last, Compare& comp){
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        const Distance len = last - first;
+        for (Distance child = 1; child < len; ++child){
+            if (comp(*(first + (child - 1) / Distance(Arity)), *(first + child))) return first + child;
+        }
+        return last;
+    }
+
+    /**************************** push_heap ****************************/
+    template <class RandomIter, class Compare>
+    void push_heap(RandomIter first, RandomIter last, Compare comp){
+        pocket_stl::__push_heap<2>(first, last, comp);
+    }
+
+    template <class RandomIter>
+    void push_heap(RandomIter first, RandomIter last){
+        pocket_stl::push_heap(first, last, __less());
+    }
+
+    /**************************** pop_heap ****************************/
+    template <class RandomIter, class Compare>
+    void pop_heap(RandomIter first, RandomIter last, Compare comp){
+        pocket_stl::__pop_heap<2>(first, last, comp);
+    }
+
+    template <class RandomIter>
+    void pop_heap(RandomIter first, RandomIter last){
+        pocket_stl::pop_heap(first, last, __less());
+    }
+
+    /**************************** make_heap ****************************/
+    template <class RandomIter, class Compare>
+    void make_heap(RandomIter first, RandomIter last, Compare comp){
+        pocket_stl::__make_heap<2>(first, last, comp);
+    }
+
+    template <class RandomIter>
+    void make_heap(RandomIter first, RandomIter last){
+        pocket_stl::make_heap(first, last, __less());
+    }
+
+    /**************************** sort_heap ****************************/
+    template <class RandomIter, class Compare>
+    void sort_heap(RandomIter first, RandomIter last, Compare comp){
+        pocket_stl::__sort_heap<2>(first, last, comp);
+    }
+
+    template <class RandomIter>
+    void sort_heap(RandomIter first, RandomIter last){
+        pocket_stl::sort_heap(first, last, __less());
+    }
+
+    /**************************** is_heap ****************************/
+    template <class RandomIter, class Compare>
+    RandomIter is_heap_until(RandomIter first, RandomIter last, Compare comp){
+        return pocket_stl::__is_heap_until<2>(first, last, comp);
+    }
+
+    template <class RandomIter>
+    RandomIter is_heap_until(RandomIter first, RandomIter last){
+        return pocket_stl::is_heap_until(first, last, __less());
+    }
+
+    template <class RandomIter, class Compare>
+    bool is_heap(RandomIter first, RandomIter last, Compare comp){
+        return pocket_stl::is_heap_until(first, last, comp) == last;
+    }
+
+    template <class RandomIter>
+    bool is_heap(RandomIter first, RandomIter last){
+        return pocket_stl::is_heap_until(first, last) == last;
+    }
+
+}
+
+#endif
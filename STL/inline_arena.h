@@ -0,0 +1,181 @@
+#ifndef _POCKET_INLINE_ARENA_H_
+#define _POCKET_INLINE_ARENA_H_
+
+/*
+** inline_arena / inline_allocator
+** inline_arena<N> 自带 N 字节的缓冲区，通常放在栈上；inline_allocator 先从缓冲区中按 bump-pointer 分配，
+** 缓冲区用尽后才退回 ::operator new，小的临时 vector / basic_string 在常见情况下不需要任何堆分配
+** 释放最后一次分配的块时回退指针，vector 扩容时旧块可以被下一次分配复用，
+** 最后一块还可以原地扩展（见 allocator.h 中的 reallocate_at_least）
+*/
+
+#include <cstddef>
+#include <climits>
+#include <new>
+#include "construct.h"
+#include "allocator.h"
+
+namespace pocket_stl{
+
+    template <size_t N>
+    class inline_arena{
+    private:
+        enum { __MAX_ALIGN = alignof(std::max_align_t) };
+
+        alignas(std::max_align_t) char buf_[N];
+        char* cur_;
+
+    public:
+        inline_arena() noexcept : cur_(buf_) {}
+        ~inline_arena() { cur_ = nullptr; }
+
+        inline_arena(const inline_arena&) = delete;
+        inline_arena& operator=(const inline_arena&) = delete;
+
+        static constexpr size_t size() noexcept { return N; }
+        size_t used() const noexcept { return static_cast<size_t>(cur_ - buf_); }
+        // 作废全部分配，要求缓冲区中的对象都已不再使用
+        void reset() noexcept { cur_ = buf_; }
+
+        bool owns(const void* p) const noexcept{
+            return buf_ <= static_cast<const char*>(p) && static_cast<const char*>(p) < buf_ + N;
+        }
+
+        // 对齐用的填充与 bytes 都以剩余字节数比较，对齐后的地址可能已经越过缓冲区末尾
+        void* allocate(size_t bytes, size_t align = __MAX_ALIGN){
+            const size_t remain = static_cast<size_t>(buf_ + N - cur_);
+            const size_t pad = padding(cur_, align);
+            if (pad <= remain && remain - pad >= bytes){
+                char* p = cur_ + pad;
+                cur_ = p + bytes;
+                return p;
+            }
+            return heap_allocate(bytes, align);
+        }
+
+        // 缓冲区中的块只有是最后一次分配时才能回收，align 必须与分配时相同
+        void deallocate(void* p, size_t bytes, size_t align = __MAX_ALIGN) noexcept{
+            if (owns(p)){
+                if (static_cast<char*>(p) + bytes == cur_) cur_ = static_cast<char*>(p);
+            }
+            else{
+                heap_deallocate(p, align);
+            }
+        }
+
+        // p 为最后一次分配且剩余空间足够时，把它原地扩展到 new_bytes
+        bool expand(void* p, size_t bytes, size_t new_bytes) noexcept{
+            if (!owns(p) || static_cast<char*>(p) + bytes != cur_) return false;
+            if (static_cast<size_t>(buf_ + N - static_cast<char*>(p)) < new_bytes) return false;
+            cur_ = static_cast<char*>(p) + new_bytes;
+            return true;
+        }
+
+    private:
+        // 把 p 上调到 align 的倍数需要跳过的字节数
+        static size_t padding(const char* p, size_t align) noexcept{
+            const size_t addr = reinterpret_cast<size_t>(p);
+            return ((addr + align - 1) & ~(align - 1)) - addr;
+        }
+
+        // 缓冲区用尽后的退路，超过默认对齐的请求与 __new_delete_resource 一样处理
+#if defined(__cpp_aligned_new)
+        static bool over_aligned(size_t align) noexcept{
+            return align > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        }
+        static void* heap_allocate(size_t bytes, size_t align){
+            if (over_aligned(align)) return ::operator new(bytes, std::align_val_t(align));
+            return ::operator new(bytes);
+        }
+        static void heap_deallocate(void* p, size_t align) noexcept{
+            if (over_aligned(align)) ::operator delete(p, std::align_val_t(align));
+            else                     ::operator delete(p);
+        }
+#else
+        static bool over_aligned(size_t align) noexcept{
+            return align > static_cast<size_t>(__MAX_ALIGN);
+        }
+        // 多申请 align 字节自行对齐，原始地址记录在返回地址之前
+        static void* heap_allocate(size_t bytes, size_t align){
+            if (!over_aligned(align)) return ::operator new(bytes);
+            char* raw = static_cast<char*>(::operator new(bytes + align + sizeof(void*)));
+            char* p = raw + sizeof(void*);
+            p += padding(p, align);
+            reinterpret_cast<void**>(p)[-1] = raw;
+            return p;
+        }
+        static void heap_deallocate(void* p, size_t align) noexcept{
+            if (over_aligned(align)) ::operator delete(static_cast<void**>(p)[-1]);
+            else                     ::operator delete(p);
+        }
+#endif
+    };
+
+    // ---------------------------------------------------------------------------------------
+    // inline_allocator
+    // 必须由 inline_arena 构造，容器的生命周期不能超过 arena，例如：
+    //   inline_arena<4096> arena;
+    //   vector<int, inline_allocator<int, 4096>> v(arena);
+
+    template <class T, size_t N>
+    class inline_allocator{
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        typedef inline_arena<N> arena_type;
+
+        template <class U>
+        struct rebind{
+            typedef inline_allocator<U, N> other;
+        };
+
+    private:
+        template <class, size_t> friend class inline_allocator;
+        arena_type* arena_;
+
+    public:
+        inline_allocator(arena_type& arena) noexcept : arena_(&arena) {}
+        template <class U>
+        inline_allocator(const inline_allocator<U, N>& rhs) noexcept : arena_(rhs.arena_) {}
+
+        arena_type*     arena() const noexcept { return arena_; }
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return size_type(UINT_MAX / sizeof(T)); }
+
+        pointer allocate(size_type n){
+            return static_cast<pointer>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+        // 只做原地扩展，不会搬移
+        allocation_result<pointer> reallocate_at_least(pointer p, size_type n, size_type new_n, bool) noexcept{
+            if (p != nullptr && arena_->expand(p, n * sizeof(T), new_n * sizeof(T))) return { p, new_n };
+            return { nullptr, 0 };
+        }
+        void deallocate(pointer p, size_type n){
+            if (p != nullptr) arena_->deallocate(p, n * sizeof(T), alignof(T));
+        }
+        void deallocate(pointer p) { deallocate(p, 1); }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+
+        template <class U>
+        bool operator==(const inline_allocator<U, N>& rhs) const noexcept { return arena_ == rhs.arena_; }
+        template <class U>
+        bool operator!=(const inline_allocator<U, N>& rhs) const noexcept { return arena_ != rhs.arena_; }
+    };
+
+}
+
+#endif
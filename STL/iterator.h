@@ -2,6 +2,7 @@
 #define _POCKET_ITERATOR_H_
 
 #include <cstddef>
+#include <type_traits>
 
 namespace pocket_stl{
 
@@ -74,6 +75,57 @@ namespace pocket_stl{
         return static_cast<typename iterator_traits<Iterator>::difference_type*>(0);
     }
 
+    /**************************** distance ****************************/
+    template <class InputIterator>
+    inline typename iterator_traits<InputIterator>::difference_type
+    __distance(InputIterator first, InputIterator last, input_iterator_tag){
+        typename iterator_traits<InputIterator>::difference_type n = 0;
+        for (; first != last; ++first) ++n;
+        return n;
+    }
+
+    template <class RandomIter>
+    inline typename iterator_traits<RandomIter>::difference_type
+    __distance(RandomIter first, RandomIter last, random_access_iterator_tag){
+        return last - first;
+    }
+
+    template <class InputIterator>
+    inline typename iterator_traits<InputIterator>::difference_type
+    distance(InputIterator first, InputIterator last){
+        return pocket_stl::__distance(first, last, iterator_category(first));
+    }
+
+    /**************************** advance ****************************/
+    template <class InputIterator, class Distance>
+    inline void __advance(InputIterator& it, Distance n, input_iterator_tag){
+        for (; n > 0; --n) ++it;
+    }
+
+    template <class BidirectionalIterator, class Distance>
+    inline void __advance(BidirectionalIterator& it, Distance n, bidrectional_iterator_tag){
+        if (n >= 0) for (; n > 0; --n) ++it;
+        else        for (; n < 0; ++n) --it;
+    }
+
+    template <class RandomIter, class Distance>
+    inline void __advance(RandomIter& it, Distance n, random_access_iterator_tag){
+        it += n;
+    }
+
+    template <class InputIterator, class Distance>
+    inline void advance(InputIterator& it, Distance n){
+        pocket_stl::__advance(it, n, iterator_category(it));
+    }
+
+    // 分段迭代器（如 deque 的迭代器）遍历的是若干段各自连续的空间，算法可以逐段处理
+    // 特化时 is_segmented 为 true_type，并提供 segment_iterator、local_iterator 以及
+    // segment(it)、local(it)、begin(seg)、end(seg)、compose(seg, local)
+    template <class Iterator>
+    struct __segmented_iterator_traits{
+        typedef std::false_type is_segmented;
+    };
+
 
 
     /*
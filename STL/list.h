@@ -170,27 +170,38 @@ namespace pocket_stl{
         /***************ctor 、 copy_ctor 、 move_ctor 、 dtor 、 operator=*****************/
         // **** default ctor
         list() { empty_initialize(); }
+        explicit list(const allocator_type& alloc)
+            : data_allocator(nullptr, alloc), node_allocator(0, alloc) { empty_initialize(); }
         // **** fill ctor
-        explicit list(size_type n){
+        explicit list(size_type n, const allocator_type& alloc = allocator_type())
+            : data_allocator(nullptr, alloc), node_allocator(0, alloc){
             allocate_and_fill(n, value_type());
         }
-        list(size_type n, const value_type& val){
+        list(size_type n, const value_type& val, const allocator_type& alloc = allocator_type())
+            : data_allocator(nullptr, alloc), node_allocator(0, alloc){
             allocate_and_fill(n, val);
         }
         // **** range ctor
         template <class InputIterator,
                   class = typename std::enable_if<
                       !std::is_integral<InputIterator>::value>::type>
-        list(InputIterator first, InputIterator last) { allocate_and_copy(first, last); }
+        list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+            : data_allocator(nullptr, alloc), node_allocator(0, alloc) { allocate_and_copy(first, last); }
         // **** copy ctor
-        list(const list& x) { allocate_and_copy(x.begin(), x.end()); }
+        // 复制 x 的 allocator
+        list(const list& x)
+            : data_allocator(nullptr, x.data_allocator.get_allocator()),
+              node_allocator(0, x.node_allocator.get_allocator()) { allocate_and_copy(x.begin(), x.end()); }
         // **** move ctor
-        list(list&& x){
-            __node_ptr() = x.__node_ptr();
+        // allocator 随节点一起转移
+        list(list&& x)
+            : data_allocator(x.__node_ptr(), x.data_allocator.get_allocator()),
+              node_allocator(x.__size(), x.node_allocator.get_allocator()){
             x.__node_ptr() = nullptr;
         }
         // **** initializer list
-        list(std::initializer_list<value_type> il) { allocate_and_copy(il.begin(), il.end()); }
+        list(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+            : data_allocator(nullptr, alloc), node_allocator(0, alloc) { allocate_and_copy(il.begin(), il.end()); }
         // **** dtor
         ~list() { destroy_and_deallocate_all(); }
         // **** operator=
@@ -289,12 +300,12 @@ namespace pocket_stl{
         void        sort (Compare comp);
         void        reverse() noexcept;
         /************************ Observers ***********************/
-        allocator_type get_allocator() const noexcept { return allocator_type(); }
+        allocator_type get_allocator() const noexcept { return data_allocator.get_allocator(); }
 
     private:
         /***********************辅助工具*****************************/
         link_type   get_node() { return node_allocator.allocate(1); }           // 配置一个节点并传回
-        void        put_node(link_type p) { node_allocator.deallocate(p); }     // 释放一个节点
+        void        put_node(link_type p) { node_allocator.deallocate(p, 1); }     // 释放一个节点
         template <class... Args>
         link_type   create_node(Args&&... args);                                // 分配并构造一个节点
         void        destroy_node(link_type p);
@@ -405,6 +416,8 @@ namespace pocket_stl{
         __size() ^= x.__size();
         x.__size() ^= __size();
         __size() ^= x.__size();
+        std::swap(data_allocator.get_allocator(), x.data_allocator.get_allocator());
+        std::swap(node_allocator.get_allocator(), x.node_allocator.get_allocator());
     }
 
     template <class T, class Alloc>
@@ -701,6 +714,7 @@ namespace pocket_stl{
     template <class T, class Alloc>
     void
     list<T, Alloc>::destroy_and_deallocate_all(){
+        if (__node_ptr() == nullptr) return;       // 已被 move
         iterator cur(__node_ptr()->next);
         iterator next(cur.node_ptr->next);
         while(cur != __node_ptr()){
@@ -855,6 +869,10 @@ namespace pocket_stl{
         x.swap(y);
     }
 
+    // 哨兵节点分配在堆上，list 本身可以按位搬移
+    template <class T, class Alloc>
+    struct is_trivially_relocatable<list<T, Alloc>> : is_trivially_relocatable<Alloc> {};
+
 } // namespace
 
 #endif
\ No newline at end of file
@@ -81,9 +81,8 @@ namespace pocket_stl{
 
     private:
         void allocate_buffer();
-        void initialize_buffer(const T&, std::true_type) {}
-        void initialize_buffer(const T& value, std::false_type)
-        { pocket_stl::uninitialized_fill_n(buffer, len, value); }
+        void initialize_buffer(ForwardIterator, std::true_type) {}
+        void initialize_buffer(ForwardIterator seed, std::false_type);
 
     private:
         temporary_buffer(const temporary_buffer&);
@@ -93,12 +92,12 @@ namespace pocket_stl{
     // 构造函数
     template <class ForwardIterator, class T>
     temporary_buffer<ForwardIterator, T>::
-    temporary_buffer(ForwardIterator first, ForwardIterator last){
+    temporary_buffer(ForwardIterator first, ForwardIterator last) : original_len(0), len(0), buffer(nullptr){
         try{
-            len = std::distance(first, last);
+            len = pocket_stl::distance(first, last);
             allocate_buffer();
             if (len > 0){
-                initialize_buffer(*first, std::is_trivially_default_constructible<T>());
+                initialize_buffer(first, std::is_trivially_default_constructible<T>());
             }
         }
         catch (...){
@@ -108,6 +107,24 @@ namespace pocket_stl{
         }
     }
 
+    // 缓冲区中的元素由 *seed 依次移动构造而来，最后把值移回 *seed，只要求 T 可移动构造，不复制元素
+    template <class ForwardIterator, class T>
+    void temporary_buffer<ForwardIterator, T>::initialize_buffer(ForwardIterator seed, std::false_type){
+        T* cur = buffer;
+        pocket_stl::construct(cur, std::move(*seed));
+        try{
+            for (++cur; cur != buffer + len; ++cur){
+                pocket_stl::construct(cur, std::move(*(cur - 1)));
+            }
+        }
+        catch (...){
+            *seed = std::move(*(cur - 1));
+            pocket_stl::destroy(buffer, cur);
+            throw;
+        }
+        *seed = std::move(*(cur - 1));
+    }
+
     template <class ForwardIterator, class T>
     void temporary_buffer<ForwardIterator, T>::allocate_buffer(){
         original_len = len;
@@ -0,0 +1,242 @@
+#ifndef _POCKET_MEMORY_RESOURCE_H_
+#define _POCKET_MEMORY_RESOURCE_H_
+
+/*
+** memory_resource / polymorphic_allocator
+** 容器的 Alloc 固定为 polymorphic_allocator<T>，具体的分配策略由运行时传入的 memory_resource 决定，
+** 切换 pool、arena 等策略不需要重新实例化容器模板
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <climits>
+#include <new>
+#include "construct.h"
+#include "alloc.h"
+#include "arena.h"
+
+namespace pocket_stl{
+namespace pmr{
+
+    class memory_resource{
+    protected:
+        enum { __MAX_ALIGN = alignof(std::max_align_t) };
+
+    public:
+        virtual ~memory_resource() {}
+
+        void* allocate(size_t bytes, size_t alignment = __MAX_ALIGN){
+            return do_allocate(bytes, alignment);
+        }
+        void deallocate(void* p, size_t bytes, size_t alignment = __MAX_ALIGN){
+            do_deallocate(p, bytes, alignment);
+        }
+        bool is_equal(const memory_resource& other) const noexcept{
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void*   do_allocate(size_t bytes, size_t alignment) = 0;
+        virtual void    do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+        virtual bool    do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept{
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+    inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept{
+        return !(lhs == rhs);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // 内置的几种 memory_resource
+
+    // 直接调用 ::operator new / ::operator delete，超过默认对齐的请求使用 aligned new；
+    // 不支持 aligned new（C++17 之前）时多申请 alignment 字节自行对齐，原始地址记录在返回地址之前
+    class __new_delete_resource : public memory_resource{
+    private:
+#if defined(__cpp_aligned_new)
+        static bool __over_aligned(size_t alignment) noexcept{
+            return alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        }
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            if (__over_aligned(alignment)) return ::operator new(bytes, std::align_val_t(alignment));
+            return ::operator new(bytes);
+        }
+        void do_deallocate(void* p, size_t, size_t alignment) override{
+            if (__over_aligned(alignment)) ::operator delete(p, std::align_val_t(alignment));
+            else                           ::operator delete(p);
+        }
+#else
+        static bool __over_aligned(size_t alignment) noexcept{
+            return alignment > static_cast<size_t>(__MAX_ALIGN);
+        }
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            if (!__over_aligned(alignment)) return ::operator new(bytes);
+            char* raw = static_cast<char*>(::operator new(bytes + alignment + sizeof(void*)));
+            const size_t addr = reinterpret_cast<size_t>(raw + sizeof(void*));
+            char* p = reinterpret_cast<char*>((addr + alignment - 1) & ~(alignment - 1));
+            reinterpret_cast<void**>(p)[-1] = raw;
+            return p;
+        }
+        void do_deallocate(void* p, size_t, size_t alignment) override{
+            if (__over_aligned(alignment)) ::operator delete(static_cast<void**>(p)[-1]);
+            else                           ::operator delete(p);
+        }
+#endif
+        bool do_is_equal(const memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+    };
+
+    // 任何分配都抛出 std::bad_alloc，用于确认某段代码不会分配内存
+    class __null_memory_resource : public memory_resource{
+    private:
+        void* do_allocate(size_t, size_t) override{
+            throw std::bad_alloc();
+        }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+    };
+
+    inline memory_resource* new_delete_resource() noexcept{
+        static __new_delete_resource res;
+        return &res;
+    }
+
+    inline memory_resource* null_memory_resource() noexcept{
+        static __null_memory_resource res;
+        return &res;
+    }
+
+    // 走 alloc.h 中带线程缓存的内存池，小于 __MAX_BYTES 的块只保证 __ALIGN 对齐，
+    // 要求更高对齐时退回 new_delete_resource，0 字节按 1 字节处理
+    class pool_resource : public memory_resource{
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            if (bytes == 0) bytes = 1;
+            if (alignment > pool_alloc::alignment())
+                return new_delete_resource()->allocate(bytes, alignment);
+            return pool_thread_cache::allocate(bytes);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override{
+            if (bytes == 0) bytes = 1;
+            if (alignment > pool_alloc::alignment())
+                new_delete_resource()->deallocate(p, bytes, alignment);
+            else
+                pool_thread_cache::deallocate(p, bytes);
+        }
+        // 所有 pool_resource 共享同一个内存池
+        bool do_is_equal(const memory_resource& other) const noexcept override{
+            return dynamic_cast<const pool_resource*>(&other) != nullptr;
+        }
+    };
+
+    // 把 monotonic_arena 包装成 memory_resource，回收仍由 arena_scope / release() 负责
+    class arena_resource : public memory_resource{
+    private:
+        monotonic_arena& arena_;
+
+    public:
+        explicit arena_resource(monotonic_arena& arena) noexcept : arena_(arena) {}
+
+        monotonic_arena& arena() const noexcept { return arena_; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            return arena_.allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t) override{
+            arena_.deallocate(p, bytes);
+        }
+        bool do_is_equal(const memory_resource& other) const noexcept override{
+            const arena_resource* rhs = dynamic_cast<const arena_resource*>(&other);
+            return rhs != nullptr && &rhs->arena_ == &arena_;
+        }
+    };
+
+    // ---------------------------------------------------------------------------------------
+    // 默认 memory_resource，默认构造的 polymorphic_allocator 使用它
+
+    inline std::atomic<memory_resource*>& __default_resource() noexcept{
+        static std::atomic<memory_resource*> res(new_delete_resource());
+        return res;
+    }
+
+    inline memory_resource* get_default_resource() noexcept{
+        return __default_resource().load(std::memory_order_acquire);
+    }
+
+    // 传入 nullptr 时恢复为 new_delete_resource，返回之前的默认值
+    inline memory_resource* set_default_resource(memory_resource* r) noexcept{
+        if (r == nullptr) r = new_delete_resource();
+        return __default_resource().exchange(r, std::memory_order_acq_rel);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // polymorphic_allocator
+
+    template <class T>
+    class polymorphic_allocator{
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        template <class U>
+        struct rebind{
+            typedef polymorphic_allocator<U> other;
+        };
+
+    private:
+        memory_resource* resource_;
+
+    public:
+        polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+        polymorphic_allocator(memory_resource* r) noexcept : resource_(r ? r : get_default_resource()) {}
+        template <class U>
+        polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept : resource_(rhs.resource()) {}
+
+        memory_resource* resource() const noexcept { return resource_; }
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return size_type(UINT_MAX / sizeof(T)); }
+
+        pointer allocate(size_type n){
+            return static_cast<pointer>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+        // memory_resource 需要知道归还的大小，因此不提供 deallocate(p)
+        void deallocate(pointer p, size_type n){
+            if (p == nullptr) return;
+            resource_->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept{
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template <class T, class U>
+    bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept{
+        return !(lhs == rhs);
+    }
+
+} // namespace pmr
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef _POCKET_MMAP_ALLOC_H_
+#define _POCKET_MMAP_ALLOC_H_
+
+/*
+** mmap_allocator
+** 大于等于 __MMAP_THRESHOLD 的请求直接向内核 mmap 匿名页，释放时 munmap 立即归还，
+** HugePages 为 true 时对足够大的映射调用 madvise(MADV_HUGEPAGE)，由透明大页减少 TLB miss；
+** Linux 上扩容通过 mremap 完成，能原地扩展时不搬移元素，trivially relocatable 的元素还可以由内核换页搬移。
+** 小请求以及不支持 mmap 的平台退回 ::operator new
+*/
+
+#include <cstddef>
+#include <climits>
+#include <new>
+#include "construct.h"
+#include "allocator.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define POCKET_HAS_MMAP 1
+#endif
+
+namespace pocket_stl{
+
+    template <bool HugePages>
+    class __mmap_storage{
+    private:
+        enum { __MMAP_THRESHOLD = 1 << 20 };        // 1 MiB 以下的请求不值得单独映射
+        enum { __HUGE_PAGE_SIZE = 1 << 21 };        // x86-64 / aarch64 上透明大页的大小
+
+    public:
+        // 按页上调后再比较，归还时传入的 count * sizeof(T) 略小于映射长度也能得到同样的判断
+        static bool use_mmap(size_t bytes) noexcept{
+#ifdef POCKET_HAS_MMAP
+            return ((bytes + page_size() - 1) & ~(page_size() - 1)) >= __MMAP_THRESHOLD;
+#else
+            (void)bytes;
+            return false;
+#endif
+        }
+
+        // 映射的实际长度：按页上调，使用大页时按大页上调
+        static size_t map_size(size_t bytes) noexcept{
+            const size_t unit = HugePages && bytes >= __HUGE_PAGE_SIZE ? size_t(__HUGE_PAGE_SIZE) : page_size();
+            return (bytes + unit - 1) & ~(unit - 1);
+        }
+
+        // bytes 已经过 map_size 上调
+        static void* allocate(size_t bytes){
+            if (!use_mmap(bytes)) return ::operator new(bytes);
+#ifdef POCKET_HAS_MMAP
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            advise(p, bytes);
+            return p;
+#else
+            return ::operator new(bytes);
+#endif
+        }
+
+        static void deallocate(void* p, size_t bytes) noexcept{
+            if (p == nullptr) return;
+            if (!use_mmap(bytes)){
+                ::operator delete(p);
+                return;
+            }
+#ifdef POCKET_HAS_MMAP
+            ::munmap(p, bytes);
+#endif
+        }
+
+        // 只处理已经 mmap 的区块，失败返回 nullptr，原映射保持不变
+        static void* remap(void* p, size_t old_bytes, size_t new_bytes, bool may_move) noexcept{
+#if defined(POCKET_HAS_MMAP) && defined(__linux__)
+            if (!use_mmap(old_bytes)) return nullptr;
+            void* q = ::mremap(p, old_bytes, new_bytes, may_move ? MREMAP_MAYMOVE : 0);
+            if (q == MAP_FAILED) return nullptr;
+            advise(q, new_bytes);
+            return q;
+#else
+            (void)p; (void)old_bytes; (void)new_bytes; (void)may_move;
+            return nullptr;
+#endif
+        }
+
+    private:
+        static size_t page_size() noexcept{
+#ifdef POCKET_HAS_MMAP
+            static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return size;
+#else
+            return 4096;
+#endif
+        }
+
+        static void advise(void* p, size_t bytes) noexcept{
+#if defined(POCKET_HAS_MMAP) && defined(MADV_HUGEPAGE)
+            if (HugePages && bytes >= __HUGE_PAGE_SIZE) ::madvise(p, bytes, MADV_HUGEPAGE);
+#else
+            (void)p; (void)bytes;
+#endif
+        }
+    };
+
+    // ---------------------------------------------------------------------------------------
+    // mmap_allocator
+    // 适合作为超大 vector / deque 的 Alloc；deallocate 必须传入分配时得到的个数，容器均满足这一点
+
+    template <class T, bool HugePages = true>
+    class mmap_allocator{
+    private:
+        typedef __mmap_storage<HugePages> storage;
+
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        template <class U>
+        struct rebind{
+            typedef mmap_allocator<U, HugePages> other;
+        };
+
+        mmap_allocator() noexcept {}
+        template <class U>
+        mmap_allocator(const mmap_allocator<U, HugePages>&) noexcept {}
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return size_type(-1) / sizeof(T); }
+
+        pointer allocate(size_type n){
+            return allocate_at_least(n).ptr;
+        }
+        // 映射按页上调，上调出来的部分同样可用
+        allocation_result<pointer> allocate_at_least(size_type n){
+            if (n == 0) return { nullptr, 0 };
+            size_t bytes = n * sizeof(T);
+            if (storage::use_mmap(bytes)) bytes = storage::map_size(bytes);
+            return { static_cast<pointer>(storage::allocate(bytes)), bytes / sizeof(T) };
+        }
+        // 由 [p, p + n) 扩展到至少 new_n 个对象，见 allocator.h 中的 reallocate_at_least
+        allocation_result<pointer> reallocate_at_least(pointer p, size_type n, size_type new_n, bool may_move) noexcept{
+            if (p == nullptr || !storage::use_mmap(n * sizeof(T))) return { nullptr, 0 };
+            const size_t new_bytes = storage::map_size(new_n * sizeof(T));
+            void* q = storage::remap(p, storage::map_size(n * sizeof(T)), new_bytes, may_move);
+            if (q == nullptr) return { nullptr, 0 };
+            return { static_cast<pointer>(q), new_bytes / sizeof(T) };
+        }
+        void deallocate(pointer p, size_type n){
+            const size_t bytes = n * sizeof(T);
+            storage::deallocate(p, storage::use_mmap(bytes) ? storage::map_size(bytes) : bytes);
+        }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+    };
+
+    template <class T, class U, bool H>
+    bool operator==(const mmap_allocator<T, H>&, const mmap_allocator<U, H>&) noexcept { return true; }
+
+    template <class T, class U, bool H>
+    bool operator!=(const mmap_allocator<T, H>&, const mmap_allocator<U, H>&) noexcept { return false; }
+
+}
+
+#endif
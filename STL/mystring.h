@@ -10,4 +10,4 @@ namespace pocket_stl{
     using u32string = pocket_stl::basic_string<char32_t>;
 } // namespace
 
-#endif
\ No newline at end of file
+#endif
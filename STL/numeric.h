@@ -0,0 +1,60 @@
+#ifndef _POCKET_NUMERIC_H_
+#define _POCKET_NUMERIC_H_
+
+/*
+** numeric
+** accumulate 严格按顺序累加；reduce 允许任意结合与交换，并行版本见 execution.h
+*/
+
+#include <utility>
+#include "iterator.h"
+
+namespace pocket_stl{
+
+    // 不指定运算时使用的 operator+
+    struct __plus{
+        template <class T, class U>
+        auto operator()(T&& x, U&& y) const -> decltype(std::forward<T>(x) + std::forward<U>(y)){
+            return std::forward<T>(x) + std::forward<U>(y);
+        }
+    };
+
+    /**************************** accumulate ****************************/
+    template <class InputIterator, class T>
+    T accumulate(InputIterator first, InputIterator last, T init){
+        for (; first != last; ++first){
+            init = std::move(init) + *first;
+        }
+        return init;
+    }
+
+    template <class InputIterator, class T, class BinaryOperation>
+    T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation op){
+        for (; first != last; ++first){
+            init = op(std::move(init), *first);
+        }
+        return init;
+    }
+
+    /**************************** reduce ****************************/
+    // op 需满足结合律与交换律，否则结果不确定
+    template <class InputIterator, class T, class BinaryOperation>
+    T reduce(InputIterator first, InputIterator last, T init, BinaryOperation op){
+        return pocket_stl::accumulate(first, last, std::move(init), op);
+    }
+
+    template <class InputIterator, class T>
+    T reduce(InputIterator first, InputIterator last, T init){
+        return pocket_stl::accumulate(first, last, std::move(init), __plus());
+    }
+
+    template <class InputIterator>
+    typename iterator_traits<InputIterator>::value_type
+    reduce(InputIterator first, InputIterator last){
+        typedef typename iterator_traits<InputIterator>::value_type T;
+        return pocket_stl::accumulate(first, last, T(), __plus());
+    }
+
+}
+
+#endif
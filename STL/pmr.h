@@ -0,0 +1,43 @@
+#ifndef _POCKET_PMR_H_
+#define _POCKET_PMR_H_
+
+/*
+** pmr
+** 以 polymorphic_allocator 为 Alloc 的容器别名
+** 单独成一个头文件，普通容器的头文件不依赖 memory_resource.h 以及其中的内存池与 arena
+*/
+
+#include "memory_resource.h"
+#include "vector.h"
+#include "list.h"
+#include "deque.h"
+#include "mystring.h"
+#include "unordered_set.h"
+
+namespace pocket_stl{
+namespace pmr{
+
+    template <class T>
+    using vector = pocket_stl::vector<T, polymorphic_allocator<T>>;
+
+    template <class T>
+    using list = pocket_stl::list<T, polymorphic_allocator<T>>;
+
+    template <class T>
+    using deque = pocket_stl::deque<T, polymorphic_allocator<T>>;
+
+    template <class charT, class traits = char_traits<charT>>
+    using basic_string = pocket_stl::basic_string<charT, traits, polymorphic_allocator<charT>>;
+
+    using string = pmr::basic_string<char>;
+    using wstring = pmr::basic_string<wchar_t>;
+    using u16string = pmr::basic_string<char16_t>;
+    using u32string = pmr::basic_string<char32_t>;
+
+    template <class Key, class Hash = hash<Key>, class Pred = equal_to<Key>>
+    using unordered_set = pocket_stl::unordered_set<Key, Hash, Pred, polymorphic_allocator<Key>>;
+
+} // namespace pmr
+} // namespace pocket_stl
+
+#endif
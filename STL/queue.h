@@ -3,10 +3,15 @@
 
 /*
 ** queue
-** 
+** priority_queue：默认在 vector 上建二叉大根堆，Arity 为 4 时使用 4 叉堆
 */
 
+#include <cstddef>
+#include <iterator>
 #include "deque.h"
+#include "vector.h"
+#include "heap.h"
+#include "functional.h"
 
 namespace pocket_stl{
     template <class T, class Container = deque<T>> class queue;
@@ -59,7 +64,7 @@ namespace pocket_stl{
     }
     template <class T, class Container>
     bool operator!= (const queue<T,Container>& lhs, const queue<T,Container>& rhs){
-        return lhs == rhs;
+        return !(lhs == rhs);
     }
     template <class T, class Container>
     bool operator<  (const queue<T,Container>& lhs, const queue<T,Container>& rhs){
@@ -81,6 +86,125 @@ namespace pocket_stl{
     void swap (queue<T,Container>& x, queue<T,Container>& y) noexcept(noexcept(x.swap(y))){
         x.swap(y);
     }
+    /**************************** priority_queue ****************************/
+    // 4 叉堆的层数是二叉堆的一半，push 上浮与 pop 下沉经过的层数都减半，一个节点的子节点挨在一起；
+    // pop 每层要多做两次比较，元素移动代价高或 push 多于 pop 时收益更明显
+    template <class T, class Container = vector<T>,
+              class Compare = less<typename Container::value_type>, size_t Arity = 2>
+    class priority_queue{
+        static_assert(Arity >= 2, "priority_queue needs at least two children per node");
+
+    public:
+        using value_type        = typename Container::value_type;
+        using container_type    = Container;
+        using value_compare     = Compare;
+        using reference         = typename Container::reference;
+        using const_reference   = typename Container::const_reference;
+        using size_type         = typename Container::size_type;
+
+    private:
+        container_type __c;
+        value_compare  __comp;
+
+    public:
+        priority_queue() : __c(), __comp() {}
+        explicit priority_queue(const value_compare& comp, const container_type& ctnr = container_type())
+            : __c(ctnr), __comp(comp){
+            pocket_stl::__make_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        priority_queue(const value_compare& comp, container_type&& ctnr)
+            : __c(std::move(ctnr)), __comp(comp){
+            pocket_stl::__make_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        template <class InputIterator>
+        priority_queue(InputIterator first, InputIterator last, const value_compare& comp = value_compare())
+            : __c(), __comp(comp){
+            __c.insert(__c.end(), first, last);
+            pocket_stl::__make_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        template <class InputIterator>
+        priority_queue(InputIterator first, InputIterator last, const value_compare& comp, const container_type& ctnr)
+            : __c(ctnr), __comp(comp){
+            __c.insert(__c.end(), first, last);
+            pocket_stl::__make_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        template <class InputIterator>
+        priority_queue(InputIterator first, InputIterator last, const value_compare& comp, container_type&& ctnr)
+            : __c(std::move(ctnr)), __comp(comp){
+            __c.insert(__c.end(), first, last);
+            pocket_stl::__make_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        priority_queue(const priority_queue& x) : __c(x.__c), __comp(x.__comp) {}
+        priority_queue(priority_queue&& x) : __c(std::move(x.__c)), __comp(std::move(x.__comp)) {}
+        ~priority_queue() = default;
+
+        priority_queue& operator=(const priority_queue& x){
+            __c = x.__c;
+            __comp = x.__comp;
+            return *this;
+        }
+        priority_queue& operator=(priority_queue&& x){
+            __c = std::move(x.__c);
+            __comp = std::move(x.__comp);
+            return *this;
+        }
+
+        bool empty() const { return __c.empty(); }
+        size_type size() const { return __c.size(); }
+        const_reference top() const { return __c.front(); }
+
+        void push(const value_type& val){
+            __c.push_back(val);
+            pocket_stl::__push_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        void push(value_type&& val){
+            __c.push_back(std::move(val));
+            pocket_stl::__push_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        template <class... Args>
+        void emplace(Args&&... args){
+            __c.emplace_back(std::forward<Args>(args)...);
+            pocket_stl::__push_heap<Arity>(__c.begin(), __c.end(), __comp);
+        }
+        void pop(){
+            pocket_stl::__pop_heap<Arity>(__c.begin(), __c.end(), __comp);
+            __c.pop_back();
+        }
+
+        // 批量加入：新元素足够多时整体重新建堆，O(n)；否则逐个上浮，O(k log n)
+        template <class InputIterator>
+        void push_range(InputIterator first, InputIterator last){
+            const size_type old_size = __c.size();
+            __c.insert(__c.end(), first, last);
+            const size_type added = __c.size() - old_size;
+            size_type depth = 1;
+            for (size_type n = __c.size(); n >= Arity; n /= Arity) ++depth;
+            if (added * depth >= __c.size()){
+                pocket_stl::__make_heap<Arity>(__c.begin(), __c.end(), __comp);
+            }
+            else{
+                for (size_type i = old_size + 1; i <= __c.size(); ++i){
+                    pocket_stl::__push_heap<Arity>(__c.begin(), __c.begin() + i, __comp);
+                }
+            }
+        }
+        template <class Range>
+        void push_range(const Range& r){
+            push_range(std::begin(r), std::end(r));
+        }
+
+        void swap(priority_queue& x) noexcept(noexcept(__c.swap(x.__c))){
+            __c.swap(x.__c);
+            using std::swap;
+            swap(__comp, x.__comp);
+        }
+    };
+
+    template <class T, class Container, class Compare, size_t Arity>
+    void swap(priority_queue<T, Container, Compare, Arity>& x,
+              priority_queue<T, Container, Compare, Arity>& y) noexcept(noexcept(x.swap(y))){
+        x.swap(y);
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,229 @@
+#ifndef _POCKET_SELECTION_H_
+#define _POCKET_SELECTION_H_
+
+/*
+** selection
+** nth_element 使用 introselect：沿用 sort 的取枢轴与划分，每次只进入包含 nth 的一侧，期望 O(n)；
+** 失衡划分过多时改用堆选择，最坏 O(nlogn)
+** partial_sort 需要的前缀较短时用堆选择，较长时先 nth_element 再只排序前缀
+** top_k 逐个接收元素，保留按 Compare 最大的 k 个：缓冲区攒满 2k 个时 nth_element 淘汰一半，均摊 O(1)
+*/
+
+#include <cstddef>
+#include <utility>
+#include "iterator.h"
+#include "algobase.h"
+#include "heap.h"
+#include "functional.h"
+#include "algorithm.h"
+#include "vector.h"
+
+namespace pocket_stl{
+
+    enum {
+        __PARTIAL_SORT_HEAP_RATIO = 1024    // 前缀不超过区间长度的 1/1024 时 partial_sort 使用堆选择
+    };
+
+    /**************************** heap select ****************************/
+    // [first, middle) 建成大根堆，保留 [first, last) 中最小的 middle - first 个元素，堆顶是其中最大的
+    template <class RandomIter, class Compare>
+    void __heap_select(RandomIter first, RandomIter middle, RandomIter last, Compare& comp){
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        typedef typename iterator_traits<RandomIter>::value_type       T;
+        const Distance len = middle - first;
+        pocket_stl::__make_heap<2>(first, middle, comp);
+        for (RandomIter cur = middle; cur < last; ++cur){
+            if (comp(*cur, *first)){
+                T value = std::move(*cur);
+                *cur = std::move(*first);
+                pocket_stl::__adjust_heap<2>(first, Distance(0), len, std::move(value), comp);
+            }
+        }
+    }
+
+    /**************************** nth_element ****************************/
+    // leftmost 为 false 时 *(first - 1) 不大于区间内的任何元素，与 __pdqsort_loop 相同
+    template <bool Branchless, class RandomIter, class Compare>
+    void __introselect(RandomIter first, RandomIter nth, RandomIter last, Compare comp, int bad_allowed){
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        bool leftmost = true;
+        while (true){
+            const Distance size = last - first;
+            if (size < __INSERTION_SORT_THRESHOLD){
+                if (leftmost) pocket_stl::__insertion_sort(first, last, comp);
+                else          pocket_stl::__unguarded_insertion_sort(first, last, comp);
+                return;
+            }
+
+            pocket_stl::__choose_pivot(first, last, comp);
+
+            // 枢轴等于左侧相邻的元素，等于它的元素一次归到左边，它们都已在最终位置上
+            if (!leftmost && !comp(*(first - 1), *first)){
+                RandomIter equal_last = pocket_stl::__partition_left(first, last, comp);
+                if (nth <= equal_last) return;
+                first = equal_last + 1;
+                continue;
+            }
+
+            RandomIter pivot_pos = Branchless ? pocket_stl::__partition_right_branchless(first, last, comp).first
+                                              : pocket_stl::__partition_right(first, last, comp).first;
+            if (pivot_pos == nth) return;
+            const Distance l_size = pivot_pos - first;
+            const Distance r_size = last - (pivot_pos + 1);
+
+            if (l_size < size / 8 || r_size < size / 8){
+                if (--bad_allowed == 0){
+                    pocket_stl::__heap_select(first, nth + 1, last, comp);
+                    pocket_stl::__iter_swap(first, nth);
+                    return;
+                }
+                pocket_stl::__break_patterns(first, pivot_pos, last, l_size, r_size);
+            }
+
+            if (nth < pivot_pos){
+                last = pivot_pos;
+            }
+            else{
+                first = pivot_pos + 1;
+                leftmost = false;
+            }
+        }
+    }
+
+    // 完成后 *nth 是排序后应在该位置的元素，它之前的元素都不大于它，之后的都不小于它
+    template <class RandomIter, class Compare>
+    void nth_element(RandomIter first, RandomIter nth, RandomIter last, Compare comp){
+        if (last - first < 2 || nth == last) return;
+        pocket_stl::__introselect<__use_branchless_partition<RandomIter, Compare>::value>(
+            first, nth, last, comp, pocket_stl::__log2(last - first));
+    }
+
+    template <class RandomIter>
+    void nth_element(RandomIter first, RandomIter nth, RandomIter last){
+        pocket_stl::nth_element(first, nth, last, __less());
+    }
+
+    /**************************** partial_sort ****************************/
+    // 把最小的 middle - first 个元素按顺序放到 [first, middle)，其余元素的顺序不确定
+    template <class RandomIter, class Compare>
+    void partial_sort(RandomIter first, RandomIter middle, RandomIter last, Compare comp){
+        if (first == middle) return;
+        if ((middle - first) * __PARTIAL_SORT_HEAP_RATIO <= last - first){
+            pocket_stl::__heap_select(first, middle, last, comp);
+            pocket_stl::__sort_heap<2>(first, middle, comp);
+        }
+        else{
+            pocket_stl::nth_element(first, middle - 1, last, comp);
+            pocket_stl::sort(first, middle - 1, comp);
+        }
+    }
+
+    template <class RandomIter>
+    void partial_sort(RandomIter first, RandomIter middle, RandomIter last){
+        pocket_stl::partial_sort(first, middle, last, __less());
+    }
+
+    /**************************** partial_sort_copy ****************************/
+    // 输入只需遍历一次：先填满结果区间并建堆，之后只有小于堆顶的元素才替换堆顶
+    template <class InputIter, class RandomIter, class Compare>
+    RandomIter partial_sort_copy(InputIter first, InputIter last,
+                                 RandomIter result_first, RandomIter result_last, Compare comp){
+        typedef typename iterator_traits<RandomIter>::difference_type  Distance;
+        typedef typename iterator_traits<RandomIter>::value_type       T;
+        RandomIter result_real_last = result_first;
+        for (; first != last && result_real_last != result_last; ++first, ++result_real_last){
+            *result_real_last = *first;
+        }
+        if (result_real_last == result_first) return result_real_last;
+        const Distance len = result_real_last - result_first;
+        pocket_stl::__make_heap<2>(result_first, result_real_last, comp);
+        for (; first != last; ++first){
+            if (comp(*first, *result_first)){
+                pocket_stl::__adjust_heap<2>(result_first, Distance(0), len, T(*first), comp);
+            }
+        }
+        pocket_stl::__sort_heap<2>(result_first, result_real_last, comp);
+        return result_real_last;
+    }
+
+    template <class InputIter, class RandomIter>
+    RandomIter partial_sort_copy(InputIter first, InputIter last, RandomIter result_first, RandomIter result_last){
+        return pocket_stl::partial_sort_copy(first, last, result_first, result_last, __less());
+    }
+
+    /**************************** top_k ****************************/
+    // 淘汰过之后 __buf[0] 是保留下来的第 k 大的元素，不大于它的新元素直接丢弃
+    template <class T, class Compare = less<T>>
+    class top_k{
+    public:
+        typedef T           value_type;
+        typedef Compare     value_compare;
+        typedef size_t      size_type;
+
+    private:
+        vector<T>   __buf;
+        size_type   __k;
+        Compare     __comp;
+        bool        __pruned;
+
+    public:
+        explicit top_k(size_type k, const Compare& comp = Compare())
+            : __buf(), __k(k), __comp(comp), __pruned(false) {}
+
+        size_type   k()     const noexcept { return __k; }
+        size_type   size()  const noexcept { return __buf.size() < __k ? __buf.size() : __k; }
+        bool        empty() const noexcept { return __buf.empty(); }
+
+        void push(const value_type& value){
+            if (__rejects(value)) return;
+            __buf.push_back(value);
+            if (__buf.size() == 2 * __k) __prune();
+        }
+
+        void push(value_type&& value){
+            if (__rejects(value)) return;
+            __buf.push_back(std::move(value));
+            if (__buf.size() == 2 * __k) __prune();
+        }
+
+        template <class InputIter>
+        void push(InputIter first, InputIter last){
+            for (; first != last; ++first) push(*first);
+        }
+
+        void clear(){
+            __buf.clear();
+            __pruned = false;
+        }
+
+        // 保留的元素从大到小排列
+        vector<T> sorted() const{
+            vector<T> result(__buf);
+            const Compare& comp = __comp;
+            auto greater = [&comp](const T& a, const T& b){ return comp(b, a); };
+            if (result.size() > __k){
+                pocket_stl::nth_element(result.begin(), result.begin() + __k, result.end(), greater);
+                result.erase(result.begin() + __k, result.end());
+            }
+            pocket_stl::sort(result.begin(), result.end(), greater);
+            return result;
+        }
+
+    private:
+        bool __rejects(const value_type& value) const{
+            return __k == 0 || (__pruned && !__comp(__buf[0], value));
+        }
+
+        // 用 nth_element 找出第 k 大的元素，把它和比它大的元素移到前面，其余丢弃
+        void __prune(){
+            const size_type drop = __buf.size() - __k;
+            pocket_stl::nth_element(__buf.begin(), __buf.begin() + drop, __buf.end(), __comp);
+            pocket_stl::move(__buf.begin() + drop, __buf.end(), __buf.begin());
+            __buf.erase(__buf.begin() + __k, __buf.end());
+            __pruned = true;
+        }
+    };
+
+}
+
+#endif
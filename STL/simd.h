@@ -0,0 +1,301 @@
+#ifndef _POCKET_SIMD_H_
+#define _POCKET_SIMD_H_
+
+/*
+** 按位操作内存的向量化内核，供 algobase.h 等对 trivially copyable 类型走快速路径
+** x86 上运行时检测 AVX2，不支持时使用 SSE2；其他平台退回 memcpy
+*/
+
+#include <cstddef>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define POCKET_SIMD_X86 1
+#endif
+
+namespace pocket_stl{
+
+    // 运行时检测的结果只计算一次
+    inline bool __cpu_has_avx2() noexcept{
+#ifdef POCKET_SIMD_X86
+        static const bool has = __builtin_cpu_supports("avx2") != 0;
+        return has;
+#else
+        return false;
+#endif
+    }
+
+    /**************************** fill ****************************/
+    // block 是把元素重复写满的 32 字节，bytes 为元素大小的整数倍且元素大小整除 32，
+    // 因此每个 32 字节的边界都对齐到元素边界，尾部直接复制 block 的前缀即可
+
+#ifdef POCKET_SIMD_X86
+    __attribute__((target("avx2")))
+    inline void __fill_block_avx2(char* dst, size_t bytes, const char* block) noexcept{
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        size_t i = 0;
+        for (; i + 128 <= bytes; i += 128){
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 64), v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 96), v);
+        }
+        for (; i + 32 <= bytes; i += 32){
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+        }
+        std::memcpy(dst + i, block, bytes - i);
+    }
+#endif
+
+#if defined(POCKET_SIMD_X86) && defined(__SSE2__)
+    inline void __fill_block_sse2(char* dst, size_t bytes, const char* block) noexcept{
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
+        size_t i = 0;
+        for (; i + 64 <= bytes; i += 64){
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), hi);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 32), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 48), hi);
+        }
+        for (; i + 32 <= bytes; i += 32){
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), hi);
+        }
+        std::memcpy(dst + i, block, bytes - i);
+    }
+#endif
+
+    // 任意大小的元素：先用倍增的方式填满一个不超过 4 KiB 的窗口，再反复复制这个窗口，复制的源始终在 L1 中
+    inline void __fill_pattern(char* dst, const void* value, size_t size, size_t n) noexcept{
+        const size_t bytes = size * n;
+        const size_t window = size >= 4096 ? size : (4096 / size) * size;
+        std::memcpy(dst, value, size);
+        size_t filled = size;
+        while (filled < bytes && filled < window){
+            const size_t c = filled < bytes - filled ? filled : bytes - filled;
+            std::memcpy(dst + filled, dst, c < window - filled ? c : window - filled);
+            filled += c < window - filled ? c : window - filled;
+        }
+        while (filled < bytes){
+            const size_t c = window < bytes - filled ? window : bytes - filled;
+            std::memcpy(dst + filled, dst, c);
+            filled += c;
+        }
+    }
+
+    // 把大小为 size 字节的 value 重复写入 dst 开始的 n 个位置
+    inline void __simd_fill(void* dst, const void* value, size_t size, size_t n) noexcept{
+        if (n == 0) return;
+        char* d = static_cast<char*>(dst);
+        if (size == 1){
+            std::memset(d, *static_cast<const unsigned char*>(value), n);
+            return;
+        }
+#ifdef POCKET_SIMD_X86
+        if (size <= 32 && 32 % size == 0){
+            alignas(32) char block[32];
+            for (size_t i = 0; i < 32; i += size){
+                std::memcpy(block + i, value, size);
+            }
+            if (__cpu_has_avx2()){
+                __fill_block_avx2(d, size * n, block);
+                return;
+            }
+#ifdef __SSE2__
+            __fill_block_sse2(d, size * n, block);
+            return;
+#endif
+        }
+#endif
+        __fill_pattern(d, value, size, n);
+    }
+
+    /**************************** mismatch ****************************/
+    // 返回 [a, a + bytes) 与 [b, b + bytes) 第一个不同字节的偏移，完全相同时返回 bytes
+
+#ifdef POCKET_SIMD_X86
+    __attribute__((target("avx2")))
+    inline size_t __mismatch_bytes_avx2(const char* a, const char* b, size_t bytes) noexcept{
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32){
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        for (; i < bytes && a[i] == b[i]; ++i) {}
+        return i;
+    }
+#endif
+
+#if defined(POCKET_SIMD_X86) && defined(__SSE2__)
+    inline size_t __mismatch_bytes_sse2(const char* a, const char* b, size_t bytes) noexcept{
+        size_t i = 0;
+        for (; i + 16 <= bytes; i += 16){
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) ^ 0xFFFFu;
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        for (; i < bytes && a[i] == b[i]; ++i) {}
+        return i;
+    }
+#endif
+
+    // 没有 SIMD 时按 8 字节一组比较，找到不同的组后再逐字节定位
+    inline size_t __mismatch_bytes_scalar(const char* a, const char* b, size_t bytes) noexcept{
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8){
+            unsigned long long x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            if (x != y) break;
+        }
+        for (; i < bytes && a[i] == b[i]; ++i) {}
+        return i;
+    }
+
+    inline size_t __simd_mismatch(const void* a, const void* b, size_t bytes) noexcept{
+        const char* x = static_cast<const char*>(a);
+        const char* y = static_cast<const char*>(b);
+        // 很短的区间直接逐字节比较，省去运行时分派
+        if (bytes < 16){
+            size_t i = 0;
+            for (; i < bytes && x[i] == y[i]; ++i) {}
+            return i;
+        }
+#ifdef POCKET_SIMD_X86
+        if (__cpu_has_avx2()) return __mismatch_bytes_avx2(x, y, bytes);
+#ifdef __SSE2__
+        return __mismatch_bytes_sse2(x, y, bytes);
+#endif
+#endif
+        return __mismatch_bytes_scalar(x, y, bytes);
+    }
+
+    /**************************** find ****************************/
+    // 在 first 开始的 n 个大小为 size 字节的元素中查找与 value 按位相同的第一个，返回下标，没有时返回 n
+    // 按字节比较后，一个元素的 size 个字节都相同才算命中；block 与 fill 相同，是 value 重复写满的 32 字节
+
+    // mask 每一位对应一个字节，化简为每个元素首字节上的一位
+    inline unsigned __element_match_mask(unsigned mask, size_t size) noexcept{
+        if (size == 1) return mask;
+        mask &= mask >> 1;
+        if (size >= 4) mask &= mask >> 2;
+        if (size >= 8) mask &= mask >> 4;
+        return mask & (size == 2 ? 0x55555555u : size == 4 ? 0x11111111u : 0x01010101u);
+    }
+
+#ifdef POCKET_SIMD_X86
+    __attribute__((target("avx2")))
+    inline size_t __find_bytes_avx2(const char* p, size_t bytes, const char* block, size_t size) noexcept{
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32){
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const unsigned mask = __element_match_mask(
+                static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v))), size);
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        for (; i < bytes && std::memcmp(p + i, block, size) != 0; i += size) {}
+        return i;
+    }
+#endif
+
+#if defined(POCKET_SIMD_X86) && defined(__SSE2__)
+    inline size_t __find_bytes_sse2(const char* p, size_t bytes, const char* block, size_t size) noexcept{
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+        size_t i = 0;
+        for (; i + 16 <= bytes; i += 16){
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const unsigned mask = __element_match_mask(
+                static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, v))), size);
+            if (mask != 0) return i + __builtin_ctz(mask);
+        }
+        for (; i < bytes && std::memcmp(p + i, block, size) != 0; i += size) {}
+        return i;
+    }
+#endif
+
+    // size 为 1、2、4 或 8
+    inline size_t __simd_find(const void* first, size_t size, size_t n, const void* value) noexcept{
+        const char* p = static_cast<const char*>(first);
+        if (size == 1){
+            const void* hit = std::memchr(p, *static_cast<const unsigned char*>(value), n);
+            return hit != nullptr ? static_cast<size_t>(static_cast<const char*>(hit) - p) : n;
+        }
+        alignas(32) char block[32];
+        for (size_t i = 0; i < 32; i += size){
+            std::memcpy(block + i, value, size);
+        }
+        const size_t bytes = size * n;
+#ifdef POCKET_SIMD_X86
+        if (__cpu_has_avx2()) return __find_bytes_avx2(p, bytes, block, size) / size;
+#ifdef __SSE2__
+        return __find_bytes_sse2(p, bytes, block, size) / size;
+#endif
+#endif
+        size_t i = 0;
+        for (; i < bytes && std::memcmp(p + i, block, size) != 0; i += size) {}
+        return i / size;
+    }
+
+
+    /**************************** intersect ****************************/
+    // 32 位整数的有序集合求交：a、b 各取 4 个元素，与 b 的 4 种循环移位逐一比较相等，一次完成 16 对比较；
+    // 末元素较小（或相等）的一组前进。要求两段都没有重复元素，相等只按位比较，先后顺序由 comp 决定
+    // 返回写入 out 的个数，ia、ib 为未处理部分的起点，剩下的不足 4 个的部分由调用方逐个归并
+    template <class T, class Compare>
+    inline size_t __simd_intersect32(const T* a, size_t na, const T* b, size_t nb, T* out,
+                                     size_t& ia, size_t& ib, Compare& comp){
+        static_assert(sizeof(T) == 4, "__simd_intersect32 requires 32-bit elements");
+        size_t i = 0, j = 0, k = 0;
+#if defined(POCKET_SIMD_X86) && defined(__SSE2__)
+        while (i + 4 <= na && j + 4 <= nb){
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i eq = _mm_cmpeq_epi32(va, vb);
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+            for (; mask != 0; mask &= mask - 1){
+                out[k++] = a[i + __builtin_ctz(mask)];
+            }
+            const T a_last = a[i + 3];
+            const T b_last = b[j + 3];
+            if (!comp(b_last, a_last)) i += 4;
+            if (!comp(a_last, b_last)) j += 4;
+        }
+#else
+        (void)a; (void)na; (void)b; (void)nb; (void)out; (void)comp;
+#endif
+        ia = i;
+        ib = j;
+        return k;
+    }
+
+    // n 个 32 位元素中是否有相邻的两个按位相同
+    inline bool __simd_has_adjacent_equal32(const void* first, size_t n) noexcept{
+        const char* p = static_cast<const char*>(first);
+        size_t i = 0;
+#if defined(POCKET_SIMD_X86) && defined(__SSE2__)
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 5 <= n; i += 4){
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4 * i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4 * i + 4));
+            acc = _mm_or_si128(acc, _mm_cmpeq_epi32(x, y));
+        }
+        if (_mm_movemask_epi8(acc) != 0) return true;
+#endif
+        for (; i + 1 < n; ++i){
+            if (std::memcmp(p + 4 * i, p + 4 * i + 4, 4) == 0) return true;
+        }
+        return false;
+    }
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef _POCKET_TRACKING_ALLOCATOR_H_
+#define _POCKET_TRACKING_ALLOCATOR_H_
+
+/*
+** tracking_allocator
+** 包装另一个 allocator，按 Tag 统计分配次数、释放次数、当前占用字节数、峰值与分配大小的直方图，
+** 用不同的 Tag 区分不同的容器，即可看出哪些容器产生了分配器的流量
+** 统计使用 relaxed 原子操作，多线程下各计数各自准确，但快照不是某一时刻的一致视图
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include "construct.h"
+#include "allocator.h"
+
+namespace pocket_stl{
+
+    // 某一时刻的统计结果
+    struct allocation_snapshot{
+        enum { __HISTOGRAM_SIZE = 32 };     // 第 i 格统计大小落在 [2^i, 2^(i+1)) 字节的分配，最后一格包括更大的分配
+
+        size_t      allocations;
+        size_t      deallocations;
+        long long   bytes_live;             // reset 之前分配、之后释放的空间会使其偏小
+        long long   peak_bytes;
+        size_t      histogram[__HISTOGRAM_SIZE];
+
+        // 输出为一个 JSON 对象，直方图只列出非零的格子，le 为该格的上界（不含）
+        std::string to_json() const{
+            char buf[128];
+            std::snprintf(buf, sizeof(buf),
+                          "{\"allocations\":%zu,\"deallocations\":%zu,\"bytes_live\":%lld,\"peak_bytes\":%lld,\"histogram\":[",
+                          allocations, deallocations, bytes_live, peak_bytes);
+            std::string json(buf);
+            bool first = true;
+            for (size_t i = 0; i < __HISTOGRAM_SIZE; ++i){
+                if (histogram[i] == 0) continue;
+                if (i + 1 == __HISTOGRAM_SIZE)
+                    std::snprintf(buf, sizeof(buf), "%s{\"le\":null,\"count\":%zu}", first ? "" : ",", histogram[i]);
+                else
+                    std::snprintf(buf, sizeof(buf), "%s{\"le\":%zu,\"count\":%zu}", first ? "" : ",",
+                                  static_cast<size_t>(1) << (i + 1), histogram[i]);
+                json += buf;
+                first = false;
+            }
+            json += "]}";
+            return json;
+        }
+    };
+
+    // 每个 Tag 一份的全局统计
+    template <class Tag>
+    class tracking_stats{
+    private:
+        typedef allocation_snapshot snapshot_type;
+
+        struct counters{
+            std::atomic<size_t>     allocations;
+            std::atomic<size_t>     deallocations;
+            std::atomic<long long>  bytes_live;
+            std::atomic<long long>  peak_bytes;
+            std::atomic<size_t>     histogram[snapshot_type::__HISTOGRAM_SIZE];
+        };
+
+        // 静态存储期的对象先于动态初始化被零初始化，计数器从 0 开始
+        static counters& get() noexcept{
+            static counters c;
+            return c;
+        }
+
+        static size_t histogram_index(size_t bytes) noexcept{
+            size_t i = 0;
+            while (bytes > 1 && i + 1 < snapshot_type::__HISTOGRAM_SIZE){
+                bytes >>= 1;
+                ++i;
+            }
+            return i;
+        }
+
+    public:
+        static void on_allocate(size_t bytes) noexcept{
+            counters& c = get();
+            c.allocations.fetch_add(1, std::memory_order_relaxed);
+            c.histogram[histogram_index(bytes)].fetch_add(1, std::memory_order_relaxed);
+            const long long live = c.bytes_live.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed)
+                                   + static_cast<long long>(bytes);
+            long long peak = c.peak_bytes.load(std::memory_order_relaxed);
+            while (live > peak && !c.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+
+        static void on_deallocate(size_t bytes) noexcept{
+            counters& c = get();
+            c.deallocations.fetch_add(1, std::memory_order_relaxed);
+            c.bytes_live.fetch_sub(static_cast<long long>(bytes), std::memory_order_relaxed);
+        }
+
+        static snapshot_type snapshot() noexcept{
+            const counters& c = get();
+            snapshot_type s;
+            s.allocations = c.allocations.load(std::memory_order_relaxed);
+            s.deallocations = c.deallocations.load(std::memory_order_relaxed);
+            s.bytes_live = c.bytes_live.load(std::memory_order_relaxed);
+            s.peak_bytes = c.peak_bytes.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < snapshot_type::__HISTOGRAM_SIZE; ++i){
+                s.histogram[i] = c.histogram[i].load(std::memory_order_relaxed);
+            }
+            return s;
+        }
+
+        // 清零计数与直方图，峰值从当前占用重新开始；仍在使用的空间继续计入 bytes_live
+        static void reset() noexcept{
+            counters& c = get();
+            c.allocations.store(0, std::memory_order_relaxed);
+            c.deallocations.store(0, std::memory_order_relaxed);
+            c.peak_bytes.store(c.bytes_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            for (size_t i = 0; i < snapshot_type::__HISTOGRAM_SIZE; ++i){
+                c.histogram[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // ---------------------------------------------------------------------------------------
+    // tracking_allocator
+    // Base 负责实际的分配，rebind 之后 Tag 不变，容器内部的节点、map、buckets 都计入同一个 Tag
+
+    template <class T, class Tag, class Base = allocator<T>>
+    class tracking_allocator{
+    public:
+        typedef size_t          size_type;
+        typedef T               value_type;
+        typedef ptrdiff_t       difference_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef T&              reference;
+        typedef const T&        const_reference;
+
+        typedef tracking_stats<Tag> stats;
+
+        template <class U>
+        struct rebind{
+            typedef tracking_allocator<U, Tag, typename Base::template rebind<U>::other> other;
+        };
+
+    private:
+        template <class, class, class> friend class tracking_allocator;
+        Base base_;
+
+    public:
+        tracking_allocator() noexcept {}
+        explicit tracking_allocator(const Base& base) noexcept : base_(base) {}
+        template <class U, class B>
+        tracking_allocator(const tracking_allocator<U, Tag, B>& rhs) noexcept : base_(rhs.base_) {}
+
+        const Base&     base() const noexcept { return base_; }
+
+        pointer         address(reference x) const noexcept { return &x; }
+        const_pointer   address(const_reference x) const noexcept { return &x; }
+        size_type       max_size() const noexcept { return base_.max_size(); }
+
+        pointer allocate(size_type n){
+            pointer p = base_.allocate(n);
+            stats::on_allocate(n * sizeof(T));
+            return p;
+        }
+        // Base 上调出来的部分同样计入
+        allocation_result<pointer> allocate_at_least(size_type n){
+            allocation_result<pointer> r = pocket_stl::allocate_at_least(base_, n);
+            stats::on_allocate(r.count * sizeof(T));
+            return r;
+        }
+        void deallocate(pointer p, size_type n){
+            if (p == nullptr) return;
+            base_.deallocate(p, n);
+            stats::on_deallocate(n * sizeof(T));
+        }
+        void deallocate(pointer p) { deallocate(p, 1); }
+
+        void construct(pointer p, const_reference x) { pocket_stl::construct<T, T>(p, x); }
+        template <class... Args>
+        void construct(T* p, Args&&... args) { pocket_stl::construct(p, std::forward<Args>(args)...); }
+        void destroy(pointer p){
+            pocket_stl::destroy(p, typename pocket_stl::__type_traits<T>::has_trivial_destructor());
+        }
+
+        template <class U, class B>
+        bool operator==(const tracking_allocator<U, Tag, B>& rhs) const noexcept { return base_ == rhs.base_; }
+        template <class U, class B>
+        bool operator!=(const tracking_allocator<U, Tag, B>& rhs) const noexcept { return !(base_ == rhs.base_); }
+    };
+
+}
+
+#endif
@@ -5,20 +5,43 @@
 ** 萃取类型的信息
 */
 
+#include <type_traits>
 
 namespace pocket_stl{
     struct __true_type {};
     struct __false_type {};
 
+    // 把编译期的 bool 转换为 __true_type / __false_type
+    template <bool B>
+    struct __bool_type{
+        typedef     __false_type    type;
+    };
+
+    template <>
+    struct __bool_type<true>{
+        typedef     __true_type     type;
+    };
+
     // 泛化的 __type_traits
+    // 由编译器提供的 trivial 性质推导，用户定义的 C Struct 同样可以走 memmove 与跳过析构的路径
     template <class T>
     struct __type_traits{
-        typedef     __false_type    has_trivial_default_constructor;
-        typedef     __false_type    has_trivial_copy_constructor;
-        typedef     __false_type    has_trivial_assignment_operator;
-        typedef     __false_type    has_trivial_destructor;
-        typedef     __false_type    is_POD_type;                        // Plain Old Data 即标量型或传统的 C Struct 型别
-                                                                        // 必然拥有 trivial ctor / dtor / copy / assignment 函数
+        typedef typename __bool_type<std::is_trivially_default_constructible<T>::value>::type
+                                    has_trivial_default_constructor;
+        typedef typename __bool_type<std::is_trivially_copy_constructible<T>::value>::type
+                                    has_trivial_copy_constructor;
+        typedef typename __bool_type<std::is_trivially_copy_assignable<T>::value>::type
+                                    has_trivial_assignment_operator;
+        typedef typename __bool_type<std::is_trivially_destructible<T>::value>::type
+                                    has_trivial_destructor;
+        // Plain Old Data 即标量型或传统的 C Struct 型别
+        // 必然拥有 trivial ctor / dtor / copy / assignment 函数
+        // 未初始化的内存上可以直接用赋值或 memmove 代替构造
+        typedef typename __bool_type<std::is_trivially_copyable<T>::value
+                                     && std::is_trivially_copy_constructible<T>::value
+                                     && std::is_trivially_copy_assignable<T>::value
+                                     && std::is_trivially_destructible<T>::value>::type
+                                    is_POD_type;
     };
 
     // 偏特化版 __type_traits
@@ -174,6 +197,16 @@ namespace pocket_stl{
         typedef     __true_type     has_trivial_destructor;
         typedef     __true_type     is_POD_type;
     };
+
+    // is_trivially_relocatable
+    // 把对象按位搬到新地址、且不再调用原对象的析构函数，与“移动构造 + 析构原对象”等价
+    // trivially copyable 的类型天然满足；只持有指向堆内存的指针、不保存指向自身地址的类型
+    // （如 vector、basic_string）可以特化为 true，由容器在扩容或搬移元素时用 memcpy 代替逐个构造与析构
+    template <class T>
+    struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+    template <class T>
+    struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
 }
 
 #endif
\ No newline at end of file
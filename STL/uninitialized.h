@@ -6,6 +6,9 @@
 */
 
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
 #include "construct.h"
 #include "iterator.h"
 #include "algobase.h"
@@ -96,6 +99,89 @@ namespace pocket_stl{
         return __uninitialized_copy_n(first, n, result, value_type(result));
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    // uninitialized_move                                                                      //
+    // 调用 move constructor 把 [first, last) 内的对象移动到输出范围内，返回移动结束的位置        //
+    // commit or rollback                                                                      //
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+    __uninitialized_move_aux(InputIterator first, InputIterator last, ForwardIterator result, __true_type){
+        return pocket_stl::copy(first, last, result);
+    }
+
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+    __uninitialized_move_aux(InputIterator first, InputIterator last, ForwardIterator result, __false_type){
+        ForwardIterator cur = result;
+        try{
+            for (; first != last; ++first, ++cur){
+                construct(&*cur, std::move(*first));
+            }
+        }
+        catch(...){
+            for (; result != cur; ++result){
+                destroy(&*result);
+            }
+            throw;
+        }
+        return cur;
+    }
+
+    template <class InputIterator, class ForwardIterator, class T>
+    inline ForwardIterator
+    __uninitialized_move(InputIterator first, InputIterator last, ForwardIterator result, T*){
+        typedef typename __type_traits<T>::is_POD_type is_POD;
+        return __uninitialized_move_aux(first, last, result, is_POD());
+    }
+
+    template <class InputIterator, class ForwardIterator>
+    ForwardIterator
+    uninitialized_move(InputIterator first, InputIterator last, ForwardIterator result){
+        return __uninitialized_move(first, last, result, value_type(result));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    // uninitialized_move_if_noexcept                                                          //
+    // 移动构造不会抛出异常（或无法复制）时移动，否则复制，保证扩容失败时原区间完好               //
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+    __uninitialized_move_if_noexcept_aux(InputIterator first, InputIterator last, ForwardIterator result, __true_type){
+        return pocket_stl::copy(first, last, result);
+    }
+
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+    __uninitialized_move_if_noexcept_aux(InputIterator first, InputIterator last, ForwardIterator result, __false_type){
+        ForwardIterator cur = result;
+        try{
+            for (; first != last; ++first, ++cur){
+                construct(&*cur, std::move_if_noexcept(*first));
+            }
+        }
+        catch(...){
+            for (; result != cur; ++result){
+                destroy(&*result);
+            }
+            throw;
+        }
+        return cur;
+    }
+
+    template <class InputIterator, class ForwardIterator, class T>
+    inline ForwardIterator
+    __uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result, T*){
+        typedef typename __type_traits<T>::is_POD_type is_POD;
+        return __uninitialized_move_if_noexcept_aux(first, last, result, is_POD());
+    }
+
+    template <class InputIterator, class ForwardIterator>
+    ForwardIterator
+    uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result){
+        return __uninitialized_move_if_noexcept(first, last, result, value_type(result));
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////
     // uninitialized_fill                                                                      //
     // 调用 copy constructor 在 [first, last) 范围内填充元素                                    //
@@ -177,6 +263,82 @@ namespace pocket_stl{
         return __uninitialized_fill_n(first, n, x, value_type(first));
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    // uninitialized_default_construct_n                                                       //
+    // 在 [first, first + n) 上做默认初始化（不是值初始化），trivial 的类型不写任何内存          //
+    // commit or rollback                                                                      //
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator
+    __uninitialized_default_construct_n_aux(ForwardIterator first, Size n, T*, __true_type){
+        std::advance(first, n);
+        return first;
+    }
+
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator
+    __uninitialized_default_construct_n_aux(ForwardIterator first, Size n, T*, __false_type){
+        ForwardIterator cur = first;
+        try{
+            for (; n != 0; --n, ++cur){
+                ::new (static_cast<void*>(&*cur)) T;
+            }
+        }
+        catch(...){
+            for (; first != cur; ++first){
+                destroy(&*first);
+            }
+            throw;
+        }
+        return cur;
+    }
+
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator
+    __uninitialized_default_construct_n(ForwardIterator first, Size n, T* p){
+        typedef typename __type_traits<T>::has_trivial_default_constructor trivial;
+        return __uninitialized_default_construct_n_aux(first, n, p, trivial());
+    }
+
+    template <class ForwardIterator, class Size>
+    ForwardIterator
+    uninitialized_default_construct_n(ForwardIterator first, Size n){
+        return __uninitialized_default_construct_n(first, n, value_type(first));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    // relocate                                                                                //
+    // 把 [first, last) 内的对象搬到以 result 开始的未初始化空间，搬完后原位置视为未初始化       //
+    // trivially relocatable 的类型只做一次 memmove，区间可以重叠                               //
+    // 否则逐个移动构造再析构原对象，要求 result 不落在 (first, last) 内                         //
+    // 返回搬移结束的位置                                                                       //
+    /////////////////////////////////////////////////////////////////////////////////////////////
+    template <class T>
+    inline T*
+    __relocate_aux(T* first, T* last, T* result, std::true_type){
+        const size_t n = static_cast<size_t>(last - first);
+        if (n != 0){
+            std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+        }
+        return result + n;
+    }
+
+    template <class T>
+    inline T*
+    __relocate_aux(T* first, T* last, T* result, std::false_type){
+        for (; first != last; ++first, ++result){
+            construct(result, std::move_if_noexcept(*first));
+            destroy(first);
+        }
+        return result;
+    }
+
+    template <class T>
+    inline T*
+    relocate(T* first, T* last, T* result){
+        return __relocate_aux(first, last, result, is_trivially_relocatable<T>());
+    }
+
 }
 
 
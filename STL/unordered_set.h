@@ -31,8 +31,12 @@ namespace pocket_stl{
     /******************** ctor \ operator= ****************/
         explicit unordered_set ( size_type n = 100/* see below */,
                          const hasher& hf = hasher(),
-                         const key_equal& eql = key_equal())
-                    : rep(n, hf, eql){ }
+                         const key_equal& eql = key_equal(),
+                         const allocator_type& alloc = allocator_type())
+                    : rep(n, hf, eql, alloc){ }
+
+        explicit unordered_set ( const allocator_type& alloc )
+                    : rep(100, hasher(), key_equal(), alloc){ }
 
         template <class InputIterator, class = typename std::enable_if<
                                            !std::is_integral<InputIterator>::value>::type>
@@ -102,9 +106,8 @@ namespace pocket_stl{
 
         hasher hash_function() const { return rep.hash_function(); }
         key_equal key_eq() const { return rep.key_eq(); }
-        allocator_type get_allocator() const noexcept { return allocator_type(); }
+        allocator_type get_allocator() const noexcept { return rep.get_allocator(); }
     };
-   
 
 }
 
@@ -47,11 +47,15 @@ namespace pocket_stl{
     public:
         /***************ctor 、 copy_ctor 、 move_ctor 、 dtor 、 operator=*****************/
         // **** default ctor
-        vector() noexcept{
+        vector() noexcept : vector(allocator_type()) {}
+
+        explicit vector(const allocator_type& alloc) noexcept
+            : __end_cap_and_allocator(nullptr, alloc){
             try{
-                __start = data_allocator().allocate(16);
+                auto r = pocket_stl::allocate_at_least(data_allocator(), 16);
+                __start = r.ptr;
                 __end = __start;
-                __end_of_storage() = __start + 16;
+                __end_of_storage() = __start + r.count;
             }
             catch(...){
                 __start = nullptr;
@@ -61,36 +65,49 @@ namespace pocket_stl{
         }
 
         // **** fill ctor
-        explicit vector(size_type n){
+        explicit vector(size_type n, const allocator_type& alloc = allocator_type())
+            : __end_cap_and_allocator(nullptr, alloc){
             allocate_and_fill(n, value_type());
         }
 
-        explicit vector(size_type n, const value_type& val){
+        vector(size_type n, const value_type& val, const allocator_type& alloc = allocator_type())
+            : __end_cap_and_allocator(nullptr, alloc){
             allocate_and_fill(n, val);
         }
 
         // **** range ctor
         // 判断 InputIterator 是否为非整型，防止匹配错误
         template <class InputIterator, class = typename std::enable_if<!std::is_integral<InputIterator>::value>::type> // 元编程 enable_if
-        vector(InputIterator first, InputIterator last){
+        vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+            : __end_cap_and_allocator(nullptr, alloc){
             range_initialize(first, last);
         }
         
         // **** copy ctor
-        vector(const vector& x){
+        // 复制 x 的 allocator
+        vector(const vector& x)
+            : __end_cap_and_allocator(nullptr, x.data_allocator().get_allocator()){
+            allocate_and_copy(x.begin(), x.end());
+        }
+
+        vector(const vector& x, const allocator_type& alloc)
+            : __end_cap_and_allocator(nullptr, alloc){
             allocate_and_copy(x.begin(), x.end());
         }
 
         // **** move ctor
+        // allocator 随存储空间一起转移
         vector(vector&& x) noexcept
-            : __start(x.__start), __end(x.__end), __end_cap_and_allocator(x.__end_of_storage()){
+            : __start(x.__start), __end(x.__end),
+              __end_cap_and_allocator(x.__end_of_storage(), x.data_allocator().get_allocator()){
             x.__start = nullptr;
             x.__end = nullptr;
             x.__end_of_storage() = nullptr;
         }
 
         // **** initializer list
-        vector(std::initializer_list<value_type> il){
+        vector(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+            : __end_cap_and_allocator(nullptr, alloc){
             allocate_and_copy(il.begin(), il.end());
         }
 
@@ -126,10 +143,16 @@ namespace pocket_stl{
         size_type   max_size() const noexcept { return size_type(-1) / sizeof(value_type); }
         void        resize(size_type n) { return resize(n, value_type()); }
         void        resize(size_type n, const value_type& val);
+        // 新增的元素只做默认初始化，trivial 的类型不会写入任何内存，留给调用者直接覆盖
+        void        resize_default_init(size_type n);
+        // n 大于 size() 时先 resize_default_init(n)，再由 op(data(), n) 写入内容并返回实际的长度 r（r <= n），最后截断到 r
+        // op 抛出异常时恢复原来的长度，下标不小于 n 的原有元素不变，[0, n) 中的元素可能已被 op 改写
+        template <class Operation>
+        void        resize_and_overwrite(size_type n, Operation op);
         size_type   capacity() const noexcept { return static_cast<size_type>(__end_of_storage() - __start); }
         bool        empty() const noexcept { return __start == __end; }
         void        reserve (size_type n);
-        void        shrink_to_fit() { vector tmp(*this); swap(tmp); }
+        void        shrink_to_fit() { vector tmp(*this, get_allocator()); swap(tmp); }
         /********************** Element Access 函数 *************************/
         reference       operator[] (size_type n) { return *(__start + n); }
         const_reference operator[] (size_type n) const{ return *(__start + n); }
@@ -179,7 +202,7 @@ namespace pocket_stl{
         template <class... Args>
         void        emplace_back (Args&&... args);
         /**********************************其它*******************************/
-        allocator_type get_allocator() const noexcept { return allocator_type(); }
+        allocator_type get_allocator() const noexcept { return data_allocator().get_allocator(); }
 
         
        private:
@@ -188,7 +211,7 @@ namespace pocket_stl{
         template <class InputIterator>
         void allocate_and_copy (InputIterator first, InputIterator last);
         template <class... Args>
-        void reallocate_and_emplace (iterator position, Args... arg);
+        void reallocate_and_emplace (iterator position, Args&&... args);
         template <class InputIterator>
         void range_initialize (InputIterator first, InputIterator last);
         template <class InputIterator>
@@ -196,6 +219,9 @@ namespace pocket_stl{
         template <class Integer>
         void range_initialize_aux (Integer n, const value_type& val, std::false_type);
         void destroy_and_deallocate_all();
+        void deallocate_storage();
+        void replace_storage(iterator position, size_type n, iterator new_start, size_type new_cap);
+        bool grow_in_place(size_type n);
     private:
         /***********************其他辅助函数*****************************/
         iterator insert_fill(iterator position, size_type n, const value_type& val);
@@ -214,12 +240,12 @@ namespace pocket_stl{
         if(this != &x){
             const size_type len = x.size();
             if(len > capacity()){
-                vector tmp(x.begin(), x.end());
+                vector tmp(x.begin(), x.end(), get_allocator());
                 swap(tmp);
             }
             else if(len >= size()){
                 pocket_stl::copy(x.begin(), x.begin() + size(), __start);
-                uninitialized_copy(x.begin() + size(), x.end(), __end);
+                pocket_stl::uninitialized_copy(x.begin() + size(), x.end(), __end);
                 __end = __start + len;
             }
             else if(len < size()){
@@ -240,6 +266,7 @@ namespace pocket_stl{
         __start = x.__start;
         __end = x.__end;
         __end_of_storage() = x.__end_of_storage();
+        data_allocator().get_allocator() = x.data_allocator().get_allocator();
         x.__start = x.__end = x.__end_of_storage() = nullptr;
         return *this;
     }
@@ -256,33 +283,63 @@ namespace pocket_stl{
     template <class T, class Alloc>
     void 
     vector<T, Alloc>::resize(size_type n, const value_type& val){
-        size_type size = size();
-        if(n < size){
+        const size_type old_size = size();
+        if(n < old_size){
             erase(__start + n, __end);
-            __end = __start + n;
         }
         else if(n > capacity()){
-            insert(__end, n - size, val);
+            insert(__end, n - old_size, val);
         }
         else{
-            uninitialized_fill_n(__end, n - size, val);
+            pocket_stl::uninitialized_fill_n(__end, n - old_size, val);
             __end = __start + n;
         }
     }
 
+    template <class T, class Alloc>
+    void
+    vector<T, Alloc>::resize_default_init(size_type n){
+        const size_type old_size = size();
+        if(n <= old_size){
+            erase(__start + n, __end);
+            return;
+        }
+        if(n > capacity()){
+            reserve(2 * old_size > n && 2 * old_size < max_size() ? 2 * old_size : n);
+        }
+        __end = uninitialized_default_construct_n(__end, n - old_size);
+    }
+
+    template <class T, class Alloc>
+    template <class Operation>
+    void
+    vector<T, Alloc>::resize_and_overwrite(size_type n, Operation op){
+        const size_type old_size = size();
+        if (n > old_size) resize_default_init(n);
+        size_type r;
+        try{
+            r = static_cast<size_type>(op(__start, n));
+        }
+        catch(...){
+            if (n > old_size) erase(__start + old_size, __end);
+            throw;
+        }
+        if (r > n){
+            if (n > old_size) erase(__start + old_size, __end);
+            throw std::length_error("vector : resize_and_overwrite returned a size larger than n");
+        }
+        erase(__start + r, __end);
+    }
+
     template <class T, class Alloc>
     void 
     vector<T, Alloc>::reserve(size_type n){
         if (n > max_size()) throw std::length_error("vector : the size requested is larger than the max_size");
         if (n <= capacity()) return;
-        
-        // pointer new_start = data_allocator.allocate(n);
-        pointer new_start = data_allocator().allocate(n);
-        pointer new_end = uninitialized_copy(__start, __end, new_start);
-        destroy_and_deallocate_all();
-        __start = new_start;
-        __end_of_storage() = new_start + n;
-        __end = new_end;
+        if (grow_in_place(n)) return;
+
+        auto r = pocket_stl::allocate_at_least(data_allocator(), n);
+        replace_storage(__end, 0, r.ptr, r.count);
     }
 
     //--------------------- Modifiers 函数
@@ -308,7 +365,7 @@ namespace pocket_stl{
             for (; ptr < __end; ++ptr, ++first){
                 *ptr = *first;
             }
-            __end = uninitialized_copy(first, last, ptr);
+            __end = pocket_stl::uninitialized_copy(first, last, ptr);
         }
         else{
             destroy_and_deallocate_all();
@@ -320,27 +377,18 @@ namespace pocket_stl{
     void        
     vector<T, Alloc>::assign(size_type n, const value_type& val){
         if(n <= size()){
-            iterator ptr = __start;
-            for (size_type i = 0; i < n; ++i, ++ptr){
-                *ptr = val;
-            }
-            for (; ptr < __end; ++ptr){
-                // data_allocator.destroy(ptr);
-                data_allocator().destroy(ptr);
-            }
+            pocket_stl::fill_n(__start, n, val);
+            pocket_stl::destroy(__start + n, __end);
             __end = __start + n;
         }
-        else if(n < capacity()){
-            iterator ptr = __start;
-            for (; ptr < __end; ++ptr){
-                *ptr = val;
-            }
-            uninitialized_fill_n(ptr, n - size());
-            __end = __start + n;
+        else if(n <= capacity()){
+            pocket_stl::fill(__start, __end, val);
+            __end = pocket_stl::uninitialized_fill_n(__end, n - size(), val);
         }
         else{
-            destroy_and_deallocate_all();
-            allocate_and_fill(n, val);
+            // val 可能引用本 vector 中的元素，先构造新的空间再交换
+            vector tmp(n, val, get_allocator());
+            swap(tmp);
         }
     }
 
@@ -366,7 +414,7 @@ namespace pocket_stl{
             for (; ptr < __end; ++ptr, ++itr_il){
                 *ptr = *itr_il;
             }
-            __end = uninitialized_copy(itr_il, il.end(), ptr);
+            __end = pocket_stl::uninitialized_copy(itr_il, il.end(), ptr);
         }
         else{
             destroy_and_deallocate_all();
@@ -383,25 +431,7 @@ namespace pocket_stl{
             ++__end;
         }
         else{            
-            const size_type new_size = 2 * size();
-            // iterator new_start = data_allocator.allocate(new_size);
-            iterator new_start = data_allocator().allocate(new_size);
-            iterator new_end = new_start;
-            try{
-                new_end = uninitialized_copy(__start, __end, new_start);
-                // data_allocator.construct(&*new_end, val);
-                data_allocator().construct(&*new_end, val);
-                ++new_end;
-            }
-            catch(...){
-                destroy(new_start, new_end);
-                // data_allocator.deallocate(new_start, new_end - new_start);
-                data_allocator().deallocate(new_start, new_end - new_start);
-                throw;
-            }
-            __start = new_start;
-            __end = new_end;
-            __end_of_storage() = __start + new_size;
+            reallocate_and_emplace(__end, val);
         }
     }
 
@@ -439,8 +469,14 @@ namespace pocket_stl{
     typename vector<T, Alloc>::iterator
     vector<T, Alloc>::erase(const_iterator position){
         iterator pos_tmp = __start + (position - __start);
+        if (is_trivially_relocatable<T>::value){
+            data_allocator().destroy(pos_tmp);
+            relocate(pos_tmp + 1, __end, pos_tmp);
+            --__end;
+            return pos_tmp;
+        }
         if(pos_tmp + 1 != __end){
-            pocket_stl::copy(pos_tmp + 1, __end, pos_tmp);
+            pocket_stl::move(pos_tmp + 1, __end, pos_tmp);
         }
         --__end;
         // data_allocator.destroy(__end);
@@ -453,11 +489,16 @@ namespace pocket_stl{
     vector<T, Alloc>::erase(const_iterator first, const_iterator last){
         iterator first_copy = __start + (first - __start);
         iterator last_copy = __start + (last - __start);
+        if (is_trivially_relocatable<T>::value){
+            pocket_stl::destroy(first_copy, last_copy);
+            __end = relocate(last_copy, __end, first_copy);
+            return first_copy;
+        }
         iterator tmp = first_copy;
         if(last != __end){
-            tmp = pocket_stl::copy(last_copy, __end, first_copy);
+            tmp = pocket_stl::move(last_copy, __end, first_copy);
         }
-        pocket_stl::destroy(tmp, last_copy);
+        pocket_stl::destroy(tmp, __end);
         __end -= last - first;
         return first_copy;
     }
@@ -469,6 +510,7 @@ namespace pocket_stl{
             std::swap(__start, x.__start);
             std::swap(__end, x.__end);
             std::swap(__end_of_storage(), x.__end_of_storage());
+            std::swap(data_allocator().get_allocator(), x.data_allocator().get_allocator());
         }
     }
 
@@ -488,21 +530,35 @@ namespace pocket_stl{
         if(__end_of_storage() != __end){
             if(position == __end){
                 // data_allocator.construct(position, std::forward<Args>(args)...);
-                data_allocator().construct(position, std::forward<Args>(args)...);
+                data_allocator().construct(pos_copy, std::forward<Args>(args)...);
+                __end++;
+                return pos_copy;
+            }
+            else if (is_trivially_relocatable<T>::value){
+                // 先构造出新元素，args 可能引用本 vector 中的元素
+                value_type tmp(std::forward<Args>(args)...);
+                relocate(pos_copy, __end, pos_copy + 1);
+                try{
+                    data_allocator().construct(pos_copy, std::move(tmp));
+                }
+                catch(...){
+                    relocate(pos_copy + 1, __end + 1, pos_copy);
+                    throw;
+                }
                 __end++;
                 return pos_copy;
             }
             else{
-                // data_allocator.construct(&*__end, *(__end - 1));
-                data_allocator().construct(&*__end, *(__end - 1));
-                pocket_stl::copy_backward(pos_copy, __end - 1, __end);
-                *position = vaule_type(std::forward<Args>(args)...);
+                value_type tmp(std::forward<Args>(args)...);
+                data_allocator().construct(&*__end, std::move(*(__end - 1)));
+                pocket_stl::move_backward(pos_copy, __end - 1, __end);
+                *pos_copy = std::move(tmp);
                 __end++;
                 return pos_copy;
             }
         }
         else{
-            reallocate_and_emplace(pos_copy, args...);
+            reallocate_and_emplace(pos_copy, std::forward<Args>(args)...);
         }
         return __start + elems_before_pos;
     }
@@ -517,7 +573,7 @@ namespace pocket_stl{
             ++__end;
         }
         else{
-            reallocate_and_emplace(__end, args...);
+            reallocate_and_emplace(__end, std::forward<Args>(args)...);
         }
     }
 
@@ -528,7 +584,7 @@ namespace pocket_stl{
         // __start = data_allocator.allocate(n);
         __start = data_allocator().allocate(n);
         __end = __start + n;
-        uninitialized_fill_n(__start, n, val);
+        pocket_stl::uninitialized_fill_n(__start, n, val);
         __end_of_storage() = __end;
     }
 
@@ -538,34 +594,36 @@ namespace pocket_stl{
     vector<T, Alloc>::allocate_and_copy(InputIterator first, InputIterator last){
         // __start = data_allocator.allocate(last - first);
         __start = data_allocator().allocate(last - first);
-        __end = uninitialized_copy(first, last, __start);
+        __end = pocket_stl::uninitialized_copy(first, last, __start);
         __end_of_storage() = __end;
     }
 
     template <class T, class Alloc>
     template <class... Args>
     void
-    vector<T, Alloc>::reallocate_and_emplace (iterator position, Args... arg){
-        const size_type new_size = 2 * size() < max_size() ? 2 * size() : size() + 1;
-        // iterator new_start = data_allocator.allocate(new_size);
-        iterator new_start = data_allocator().allocate(new_size);
-        iterator new_end = new_start;
+    vector<T, Alloc>::reallocate_and_emplace (iterator position, Args&&... args){
+        const size_type old_size = size();
+        const size_type len = old_size == 0 ? 1 : (2 * old_size < max_size() ? 2 * old_size : old_size + 1);
+        // 分配器可以扩展旧空间时交给 reserve；args 可能引用旧空间中的元素，先构造到临时对象里
+        if (position == __end && __has_reallocate_at_least<allocator_type>::value && __start != nullptr){
+            value_type tmp(std::forward<Args>(args)...);
+            reserve(len);
+            data_allocator().construct(&*__end, std::move(tmp));
+            ++__end;
+            return;
+        }
+        auto r = pocket_stl::allocate_at_least(data_allocator(), len);
+        iterator new_start = r.ptr;
+        const size_type new_size = r.count;
+        // 先构造新元素，失败时旧空间保持不变；args 可能引用旧空间中的元素，此时仍然有效
         try{
-            new_end = uninitialized_copy(__start, position, new_start);
-            // data_allocator.construct(&*new_end, std::forward<Args>(arg)...);
-            data_allocator().construct(&*new_end, std::forward<Args>(arg)...);
-            new_end++;
-            new_end = uninitialized_copy(position, __end, new_end);
+            data_allocator().construct(&*(new_start + (position - __start)), std::forward<Args>(args)...);
         }
         catch(...){
-            // data_allocator.deallocate(new_start, new_end - new_start);
-            data_allocator().deallocate(new_start, new_end - new_start);
+            data_allocator().deallocate(new_start, new_size);
             throw;
         }
-        destroy_and_deallocate_all();
-        __start = new_start;
-        __end = new_end;
-        __end_of_storage() = __start + new_size;
+        replace_storage(position, 1, new_start, new_size);
     }
 
 
@@ -589,7 +647,7 @@ namespace pocket_stl{
     // void 
     // vector<T, Alloc>::range_initialize_aux(Integer n, const value_type& val, std::false_type){
     //     __start = allocate(static_cast<size_type>(n));
-    //     uninitialized_fill_n(__start, n, val);
+    //     pocket_stl::uninitialized_fill_n(__start, n, val);
     //     __end = __start + n;
     //     __end_of_storage = __end;
     // }
@@ -601,6 +659,60 @@ namespace pocket_stl{
         // data_allocator.deallocate(__start, __end_of_storage - __start);
         data_allocator().deallocate(__start, __end_of_storage() - __start);
     }
+
+    template <class T, class Alloc>
+    void 
+    vector<T, Alloc>::deallocate_storage(){
+        data_allocator().deallocate(__start, __end_of_storage() - __start);
+    }
+
+    // 由分配器把现有空间扩展到至少 n 个元素（见 reallocate_at_least），元素不需要逐个搬移
+    // 只有 trivially relocatable 的元素允许分配器把整块空间搬到新地址，成功返回 true
+    template <class T, class Alloc>
+    bool
+    vector<T, Alloc>::grow_in_place(size_type n){
+        if (__start == nullptr) return false;
+        const size_type old_size = size();
+        auto r = pocket_stl::reallocate_at_least(data_allocator(), __start, capacity(), n,
+                                                 is_trivially_relocatable<T>::value);
+        if (r.ptr == nullptr) return false;
+        __start = r.ptr;
+        __end = __start + old_size;
+        __end_of_storage() = __start + r.count;
+        return true;
+    }
+
+    // 把现有元素转移到新空间 new_start，并在 position 处留出 n 个已由调用者构造好的元素
+    // trivially relocatable 的元素直接 memcpy，旧空间只释放不析构
+    template <class T, class Alloc>
+    void 
+    vector<T, Alloc>::replace_storage(iterator position, size_type n, iterator new_start, size_type new_cap){
+        iterator new_end;
+        if (is_trivially_relocatable<T>::value){
+            iterator new_pos = relocate(__start, position, new_start);
+            new_end = relocate(position, __end, new_pos + n);
+            deallocate_storage();
+        }
+        else{
+            // 移动构造可能抛出异常时退化为复制，保证失败后旧空间完好
+            iterator new_pos = new_start + (position - __start);
+            iterator prefix_end = new_start;
+            try{
+                prefix_end = pocket_stl::uninitialized_move_if_noexcept(__start, position, new_start);
+                new_end = pocket_stl::uninitialized_move_if_noexcept(position, __end, new_pos + n);
+            }
+            catch(...){
+                pocket_stl::destroy(new_start, prefix_end);
+                pocket_stl::destroy(new_pos, new_pos + n);
+                data_allocator().deallocate(new_start, new_cap);
+                throw;
+            }
+            destroy_and_deallocate_all();
+        }
+        __start = new_start;
+        __end = new_end;
+        __end_of_storage() = new_start + new_cap;
+    }
     
     // -------------------- 其他辅助函数
     template <class T, class Alloc>
@@ -608,19 +720,32 @@ namespace pocket_stl{
     vector<T, Alloc>::insert_fill(iterator position, size_type n, const value_type& val){
         if(n != 0){
             const size_type pos_before = position - __start;
-            if(size_type(__end_of_storage() - __end) >= n){
+            if(size_type(__end_of_storage() - __end) >= n && is_trivially_relocatable<T>::value){
+                // 整段后移 n 个位置，再在空出的位置上构造；val 可能引用本 vector 中的元素，先复制一份
+                const value_type val_copy(val);
+                relocate(position, __end, position + n);
+                try{
+                    pocket_stl::uninitialized_fill_n(position, n, val_copy);
+                }
+                catch(...){
+                    relocate(position + n, __end + n, position);
+                    throw;
+                }
+                __end += n;
+            }
+            else if(size_type(__end_of_storage() - __end) >= n){
                 const size_type elems_after = __end - position;
                 iterator old_end = __end;
                 if(elems_after > n){
-                    uninitialized_copy(__end - n, old_end, __end);
+                    pocket_stl::uninitialized_move(__end - n, old_end, __end);
                     __end += n;
-                    pocket_stl::copy_backward(position, old_end - n, old_end);
+                    pocket_stl::move_backward(position, old_end - n, old_end);
                     pocket_stl::fill(position, position + n, val);
                 }
                 else{
-                    uninitialized_fill_n(__end, n - elems_after, val);
+                    pocket_stl::uninitialized_fill_n(__end, n - elems_after, val);
                     __end = position + n;
-                    uninitialized_copy(position, old_end, position + n);
+                    pocket_stl::uninitialized_move(position, old_end, position + n);
                     __end += elems_after;
                     pocket_stl::fill(position, old_end, val);
                 }
@@ -629,27 +754,20 @@ namespace pocket_stl{
                 // 需要分配新的内存
                 const size_type old_size = size();
                 const size_type len = old_size + std::max(old_size, n);
-                // iterator new_start = data_allocator.allocate(len);
-                iterator new_start = data_allocator().allocate(len);
-                iterator new_end = new_start;
+                auto r = pocket_stl::allocate_at_least(data_allocator(), len);
+                iterator new_start = r.ptr;
                 try{
-                    new_end = uninitialized_copy(__start, position, new_start);
-                    new_end = uninitialized_fill_n(new_end, n, val);
-                    new_end = uninitialized_copy(position, __end, new_end);
+                    pocket_stl::uninitialized_fill_n(new_start + pos_before, n, val);
                 }
                 catch(...){
-                    destroy(new_start, new_end);
-                    // data_allocator.deallocate(new_start, new_end - new_start);
-                    data_allocator().deallocate(new_start, new_end - new_start);
+                    data_allocator().deallocate(new_start, r.count);
                     throw;
                 }
-                destroy_and_deallocate_all();
-                __start = new_start;
-                __end = new_end;
-                __end_of_storage() = __start + len;
+                replace_storage(position, n, new_start, r.count);
             }
             return __start + pos_before;
         }
+        return position;
     }
 
     template <class T, class Alloc>
@@ -659,21 +777,33 @@ namespace pocket_stl{
         if (first == last) return position;
         const size_type n = std::distance(first, last);
         // const size_type pos_before = position - __start;
-        if (size_type(__end_of_storage() - __end) > n){
+        if (size_type(__end_of_storage() - __end) >= n && is_trivially_relocatable<T>::value){
+            relocate(position, __end, position + n);
+            try{
+                pocket_stl::uninitialized_copy(first, last, position);
+            }
+            catch(...){
+                relocate(position + n, __end + n, position);
+                throw;
+            }
+            __end += n;
+            return position;
+        }
+        else if (size_type(__end_of_storage() - __end) > n){
             const size_type elems_after = __end - position;
             iterator old_end = __end;
             if (elems_after > n){
-                uninitialized_copy(old_end - n, old_end, old_end);
+                pocket_stl::uninitialized_move(old_end - n, old_end, old_end);
                 __end += n;
-                pocket_stl::copy_backward(position, old_end - n, old_end);
+                pocket_stl::move_backward(position, old_end - n, old_end);
                 pocket_stl::copy(first, last, position);
             }
             else{
                 InputIterator mid = first;
                 std::advance(mid, elems_after);
-                __end = uninitialized_copy(mid, last, __end);
-                __end = uninitialized_copy(position, old_end, __end);
-                uninitialized_copy(first, mid, position);
+                __end = pocket_stl::uninitialized_copy(mid, last, __end);
+                __end = pocket_stl::uninitialized_move(position, old_end, __end);
+                pocket_stl::copy(first, mid, position);
             }
             return position;
         }
@@ -682,23 +812,16 @@ namespace pocket_stl{
             const size_type elems_before_pos = position - __start;
             const size_type old_size = size();
             const size_type len = old_size + std::max(old_size, n);
-            // iterator new_start = data_allocator.allocate(len);
-            iterator new_start = data_allocator().allocate(len);
-            iterator new_end = new_start;
+            auto r = pocket_stl::allocate_at_least(data_allocator(), len);
+            iterator new_start = r.ptr;
             try{
-                new_end = uninitialized_copy(__start, position, new_start);
-                new_end = uninitialized_copy(first, last, new_end);
-                new_end = uninitialized_copy(position, __end, new_end);
+                pocket_stl::uninitialized_copy(first, last, new_start + elems_before_pos);
             }
             catch(...){
-                destroy(new_start, new_end);
-                // data_allocator.deallocate(new_start, new_end - new_start);
-                data_allocator().deallocate(new_start, new_end - new_start);
+                data_allocator().deallocate(new_start, r.count);
                 throw;
             }
-            __start = new_start;
-            __end = new_end;
-            __end_of_storage() = __start + len;
+            replace_storage(position, n, new_start, r.count);
             return __start + elems_before_pos;
         }
     }
@@ -707,13 +830,7 @@ namespace pocket_stl{
     /****************************relational operator****************************/
     template <class T, class Alloc>
     bool operator== (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs){
-        if (lhs.size() != rhs.size()) return false;
-        else{
-            for (int i = 0; i < lhs.size(); ++i){
-                if (!(lhs[i] == rhs[i])) return false;
-            }
-            return true;
-        }
+        return lhs.size() == rhs.size() && pocket_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
     template <class T, class Alloc>
@@ -723,7 +840,7 @@ namespace pocket_stl{
 
     template <class T, class Alloc>
     bool operator<  (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs){
-        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return pocket_stl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
     template <class T, class Alloc>
@@ -746,6 +863,10 @@ namespace pocket_stl{
         return x.swap(y);
     }
 
+    // vector 只持有指向堆空间的指针，可以按位搬移
+    template <class T, class Alloc>
+    struct is_trivially_relocatable<vector<T, Alloc>> : is_trivially_relocatable<Alloc> {};
+
 } // namespace
 
 #endif
\ No newline at end of file
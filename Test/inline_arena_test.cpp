@@ -0,0 +1,75 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include "../STL/inline_arena.h"
+#include "../STL/vector.h"
+
+/*
+** inline_arena / inline_allocator 的对齐与溢出到堆
+** g++ -std=c++14 -fsanitize=address,undefined inline_arena_test.cpp -o inline_arena_test && ./inline_arena_test
+** g++ -std=c++17 -fsanitize=address,undefined inline_arena_test.cpp -o inline_arena_test && ./inline_arena_test
+*/
+
+using std::cout;
+using std::endl;
+using namespace pocket_stl;
+
+struct alignas(64) wide{
+    long value;
+    wide(long v = 0) : value(v) {}
+};
+
+// buf_ 是 inline_arena 的第一个成员，放在这里时从 64 字节边界开始
+struct alignas(64) arena40{
+    inline_arena<40> arena;
+};
+
+static bool aligned(const void* p, size_t align){
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+int main(){
+    // 对齐后的地址越过缓冲区末尾时必须退回堆上
+    do{
+        arena40 holder;
+        inline_arena<40>& arena = holder.arena;
+        void* a = arena.allocate(1, 1);
+        assert(arena.owns(a));
+        void* b = arena.allocate(8, 64);
+        assert(!arena.owns(b) && aligned(b, 64));
+        *static_cast<long*>(b) = 1;
+        arena.deallocate(b, 8, 64);
+        arena.deallocate(a, 1);
+        assert(arena.used() == 0);
+    } while (0);
+
+    // 剩余空间恰好够用与差一个字节
+    do{
+        inline_arena<32> arena;
+        void* a = arena.allocate(16, 16);
+        void* b = arena.allocate(16, 16);
+        assert(arena.owns(a) && arena.owns(b) && arena.used() == 32);
+        void* c = arena.allocate(1, 1);
+        assert(!arena.owns(c));
+        arena.deallocate(c, 1, 1);
+    } while (0);
+
+    // 不同对齐的容器共用一个 arena，缓冲区用尽后继续在堆上分配
+    do{
+        inline_arena<256> arena;
+        vector<char, inline_allocator<char, 256>> bytes(arena);
+        vector<wide, inline_allocator<wide, 256>> wides(arena);
+        bytes.push_back('x');
+        for (long i = 0; i < 100; ++i){
+            wides.push_back(wide(i));
+            assert(aligned(wides.data(), 64));
+            bytes.push_back('y');
+        }
+        for (long i = 0; i < 100; ++i) assert(wides[i].value == i);
+        assert(!arena.owns(wides.data()));
+    } while (0);
+
+    cout << "inline_arena ok" << endl;
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "../STL/algorithm.h"
+#include "../STL/vector.h"
+#include "../STL/deque.h"
+
+/*
+** pocket_stl::sort 与 std::sort 的对比
+** g++ -std=c++11 -O2 sort_bench.cpp -o sort_bench && ./sort_bench
+*/
+
+using std::cout;
+using std::endl;
+
+const size_t N = 1000000;
+const int ROUNDS = 5;
+
+// 生成各种分布的输入
+template <class T, class Gen>
+std::vector<T> make_input(const std::string& pattern, Gen gen){
+    std::mt19937 rng(42);
+    std::vector<T> v(N);
+    for (size_t i = 0; i < N; ++i) v[i] = gen(rng, i);
+    if (pattern == "sorted") std::sort(v.begin(), v.end());
+    else if (pattern == "reversed") std::sort(v.begin(), v.end(), [](const T& a, const T& b){ return b < a; });
+    else if (pattern == "nearly sorted"){
+        std::sort(v.begin(), v.end());
+        for (size_t i = 0; i < N / 100; ++i) std::swap(v[rng() % N], v[rng() % N]);
+    }
+    else if (pattern == "organ pipe"){
+        std::sort(v.begin(), v.begin() + N / 2);
+        std::sort(v.begin() + N / 2, v.end(), [](const T& a, const T& b){ return b < a; });
+    }
+    return v;
+}
+
+// 返回 ROUNDS 次中最快的一次，单位毫秒
+template <class Container, class T, class Sort>
+double time_sort(const std::vector<T>& input, Sort sort){
+    double best = 1e30;
+    for (int r = 0; r < ROUNDS; ++r){
+        Container c;
+        for (size_t i = 0; i < input.size(); ++i) c.push_back(input[i]);
+        auto start = std::chrono::steady_clock::now();
+        sort(c);
+        std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - start;
+        best = std::min(best, d.count());
+    }
+    return best;
+}
+
+template <class T, class Gen>
+void bench(const std::string& type, Gen gen){
+    const char* patterns[] = { "random", "few unique", "sorted", "reversed", "nearly sorted", "organ pipe" };
+    for (const char* pattern : patterns){
+        std::vector<T> input = std::string(pattern) == "few unique"
+            ? make_input<T>(pattern, [&](std::mt19937& rng, size_t i){ return gen(rng, i % 16); })
+            : make_input<T>(pattern, gen);
+
+        double std_vec = time_sort<std::vector<T>>(input, [](std::vector<T>& c){ std::sort(c.begin(), c.end()); });
+        double pocket_vec = time_sort<pocket_stl::vector<T>>(input, [](pocket_stl::vector<T>& c){ pocket_stl::sort(c.begin(), c.end()); });
+        double pocket_deq = time_sort<pocket_stl::deque<T>>(input, [](pocket_stl::deque<T>& c){ pocket_stl::sort(c.begin(), c.end()); });
+
+        cout << std::left << std::setw(8) << type << std::setw(16) << pattern << std::right << std::fixed << std::setprecision(2)
+             << std::setw(12) << std_vec << std::setw(14) << pocket_vec << std::setw(14) << pocket_deq << endl;
+    }
+}
+
+int main(){
+    cout << "N = " << N << ", best of " << ROUNDS << " (ms)" << endl;
+    cout << std::left << std::setw(8) << "type" << std::setw(16) << "pattern" << std::right
+         << std::setw(12) << "std::sort" << std::setw(14) << "pocket vector" << std::setw(14) << "pocket deque" << endl;
+
+    bench<int>("int", [](std::mt19937& rng, size_t i){ return i < 16 ? int(i) : int(rng()); });
+    bench<double>("double", [](std::mt19937& rng, size_t i){ return i < 16 ? double(i) : double(rng()) / 3.0; });
+    bench<std::string>("string", [](std::mt19937& rng, size_t i){ return std::to_string(i < 16 ? i : size_t(rng())); });
+}